@@ -0,0 +1,35 @@
+# Writes buildinfo.hpp with the commit, compiler and flags of the build, for benchmark results.
+# Run by the GameSortBuildInfo target on every build, so the commit is never stale.
+# Expects OUTPUT, SOURCE_DIR, COMPILER and FLAGS to be defined with -D.
+
+execute_process(COMMAND git rev-parse --short=12 HEAD
+        WORKING_DIRECTORY ${SOURCE_DIR}
+        OUTPUT_VARIABLE COMMIT
+        OUTPUT_STRIP_TRAILING_WHITESPACE
+        RESULT_VARIABLE GIT_RESULT
+        ERROR_QUIET)
+if(NOT GIT_RESULT EQUAL 0)
+    set(COMMIT "unknown")
+else()
+    # Uncommitted changes to tracked files make the commit alone misleading
+    execute_process(COMMAND git status --porcelain --untracked-files=no
+            WORKING_DIRECTORY ${SOURCE_DIR}
+            OUTPUT_VARIABLE GIT_STATUS
+            ERROR_QUIET)
+    if(NOT GIT_STATUS STREQUAL "")
+        set(COMMIT "${COMMIT}-dirty")
+    endif()
+endif()
+
+string(REPLACE "\\" "\\\\" FLAGS "${FLAGS}")
+string(REPLACE "\"" "\\\"" FLAGS "${FLAGS}")
+string(STRIP "${FLAGS}" FLAGS)
+set(CONTENT "#pragma once\n\n// Generated by cmake/BuildInfo.cmake, don't edit\n#define GAMESORT_COMMIT \"${COMMIT}\"\n#define GAMESORT_COMPILER \"${COMPILER}\"\n#define GAMESORT_FLAGS \"${FLAGS}\"\n")
+
+# Only touch the file when something changed, otherwise every build would recompile its users
+if(EXISTS ${OUTPUT})
+    file(READ ${OUTPUT} EXISTING)
+endif()
+if(NOT EXISTING STREQUAL CONTENT)
+    file(WRITE ${OUTPUT} "${CONTENT}")
+endif()
@@ -0,0 +1,55 @@
+#include "FrameScheduler.hpp"
+
+FrameScheduler::FrameScheduler(const sf::Time frameBudget) : frameBudget_(frameBudget) {}
+
+void FrameScheduler::requestRedraw() {
+    redrawRequested_ = true;
+}
+
+void FrameScheduler::setAnimating(const bool animating) {
+    // Starting draws the first frame, stopping draws the final state once more
+    if (animating != animating_) {
+        redrawRequested_ = true;
+    }
+    animating_ = animating;
+}
+
+bool FrameScheduler::isAnimating() const {
+    return animating_;
+}
+
+bool FrameScheduler::nextEvent(sf::Window& window, sf::Event& event) {
+    bool received = window.pollEvent(event);
+    if (!received) {
+        if (!frameWanted_()) {
+            // Idle, sleep in the OS until there's input
+            received = window.waitEvent(event);
+        } else {
+            // A frame is wanted, wait out the rest of the budget since the last one
+            const sf::Time elapsed = sinceFrame_.getElapsedTime();
+            if (elapsed < frameBudget_) {
+                sf::sleep(frameBudget_ - elapsed);
+            }
+            return false;
+        }
+    }
+    if (received && (event.type == sf::Event::Resized || event.type == sf::Event::GainedFocus ||
+                     event.type == sf::Event::MouseEntered)) {
+        // The window system may have dropped what was on screen
+        redrawRequested_ = true;
+    }
+    return received;
+}
+
+bool FrameScheduler::frameDue() const {
+    return frameWanted_() && sinceFrame_.getElapsedTime() >= frameBudget_;
+}
+
+void FrameScheduler::frameDrawn() {
+    redrawRequested_ = false;
+    sinceFrame_.restart();
+}
+
+bool FrameScheduler::frameWanted_() const {
+    return redrawRequested_ || animating_;
+}
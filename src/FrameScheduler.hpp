@@ -0,0 +1,52 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+/**
+ * @brief Decides when a window waits for input and when it draws
+ *
+ * While nothing changes the window blocks in waitEvent and uses no CPU. A frame is drawn
+ * as soon as possible after requestRedraw(), but never sooner than the frame budget after
+ * the previous one, and animations keep drawing at most once per frame budget until they stop.
+ *
+ * Usage:
+ *     while (window.isOpen()) {
+ *         while (scheduler.nextEvent(window, event)) { ... scheduler.requestRedraw() if anything changed ... }
+ *         if (scheduler.frameDue()) { ... draw ... scheduler.frameDrawn(); }
+ *     }
+ */
+class FrameScheduler {
+public:
+    explicit FrameScheduler(sf::Time frameBudget = sf::seconds(1.0F / 60.0F));
+
+    // Something on screen changed, draw it with the next frame
+    void requestRedraw();
+
+    // Draw every frame while animating, e.g. while a progress bar moves. Safe to call every frame.
+    void setAnimating(bool animating);
+
+    [[nodiscard("Getter")]] bool isAnimating() const;
+
+    /**
+     * @brief Get the next event, or return false when it's time to draw
+     *
+     * Returns pending events first. With nothing pending, it blocks until the next event
+     * if no frame is wanted, and otherwise sleeps until the frame budget allows the next frame.
+     * Resizing and regaining focus request a redraw by themselves.
+     */
+    bool nextEvent(sf::Window& window, sf::Event& event);
+
+    // True if a frame should be drawn now
+    [[nodiscard("Getter")]] bool frameDue() const;
+
+    // Call after every drawn frame
+    void frameDrawn();
+
+private:
+    sf::Time frameBudget_;
+    sf::Clock sinceFrame_;
+    bool redrawRequested_ = true;
+    bool animating_ = false;
+
+    [[nodiscard("Getter")]] bool frameWanted_() const;
+};
@@ -1,13 +1,17 @@
 #include "Game.hpp"
 
 #include <algorithm>
+#include <cctype>
 #include <iostream>
 
-Game::Game(std::string title, std::vector<std::string> genres, const double score, std::string platform) {
+Game::Game(std::string title, std::vector<std::string> genres, const double score, std::string platform,
+           const uint64_t id, const int releaseYear) {
     this->title_ = std::move(title);
     this->genres_ = std::move(genres);
     this->score_ = score;
     this->platform_ = std::move(platform);
+    this->id_ = id;
+    this->releaseYear_ = releaseYear;
     // Sort the genres to be in alphabetical order when displayed
     std::ranges::sort(genres_.begin(), genres_.end());
 }
@@ -28,10 +32,22 @@ std::string Game::get_platform() const {
     return this->platform_;
 }
 
+uint64_t Game::get_id() const {
+    return this->id_;
+}
+
+int Game::get_release_year() const {
+    return this->releaseYear_;
+}
+
 // Enforce stability by comparing the platforms if the titles are the same
-// Technically, this won't work if both fields are the same, but our data shouldn't have duplicate games anyway
+// Different games can share a title on one platform, the loader only removes duplicates (see dedupGames),
+// so the MobyGames id breaks the remaining ties
 bool Game::compareTitles(const Game* lhs, const Game* rhs) {
     if (lhs->title_ == rhs->title_) {
+        if (lhs->platform_ == rhs->platform_) {
+            return lhs->id_ < rhs->id_;
+        }
         return lhs->platform_ < rhs->platform_;
     }
     return lhs->title_ < rhs->title_;
@@ -55,20 +71,41 @@ bool Game::compareGenres(const Game* const lhs, const Game* const rhs) {
             return lhs->genres_[i] < rhs->genres_[i];
         }
     }
-    // Shouldn't get here. Suppresses warnings.
-    return lhs->title_ < rhs->title_;
+    // One list is a prefix of the other, the shorter one goes first like a shorter word in a dictionary
+    return lhs->genres_.size() < rhs->genres_.size();
 }
 
 bool Game::comparePlatform(const Game* const lhs, const Game* const rhs) {
-    if (lhs->platform_ == rhs->platform_) {
-        return lhs->title_ < rhs->title_;
+    // Compare case-insensitively. Platforms that only differ in case count as the same platform and fall back to
+    // the title, otherwise "PC" and "pc" would tie while the titles on each still order, which isn't a strict weak
+    // ordering and leaves the sorts free to disagree
+    const auto lowerLess = [](const unsigned char left, const unsigned char right) {
+        return std::tolower(left) < std::tolower(right);
+    };
+    if (std::ranges::lexicographical_compare(lhs->platform_, rhs->platform_, lowerLess)) {
+        return true;
     }
-    // Convert to lowercase first to make the comparison case-insensitive
-    std::string leftLowerPlatform = lhs->platform_;
-    std::string rightLowerPlatform = rhs->platform_;
-    std::ranges::transform(leftLowerPlatform.begin(), leftLowerPlatform.end(), leftLowerPlatform.begin(), tolower);
-    std::ranges::transform(rightLowerPlatform.begin(), rightLowerPlatform.end(), rightLowerPlatform.begin(), tolower);
-    return (leftLowerPlatform < rightLowerPlatform);
+    if (std::ranges::lexicographical_compare(rhs->platform_, lhs->platform_, lowerLess)) {
+        return false;
+    }
+    return lhs->title_ < rhs->title_;
+}
+
+std::weak_ordering Game::orderTitles(const Game* const lhs, const Game* const rhs) {
+    return lhs->title_ <=> rhs->title_;
+}
+
+std::weak_ordering Game::orderGenres(const Game* const lhs, const Game* const rhs) {
+    // Item by item, and a list that is a prefix of the other goes first, the same as compareGenres
+    return lhs->genres_ <=> rhs->genres_;
+}
+
+std::weak_ordering Game::orderPlatforms(const Game* const lhs, const Game* const rhs) {
+    return std::lexicographical_compare_three_way(lhs->platform_.begin(), lhs->platform_.end(),
+                                                  rhs->platform_.begin(), rhs->platform_.end(),
+                                                  [](const unsigned char left, const unsigned char right) {
+                                                      return std::tolower(left) <=> std::tolower(right);
+                                                  });
 }
 
 bool Game::compareScores(const Game* const lhs, const Game* const rhs) {
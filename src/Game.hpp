@@ -1,5 +1,7 @@
 #pragma once
 
+#include <compare>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -7,7 +9,8 @@ class Game {
 public:
     Game() = delete;
 
-    Game(std::string title, std::vector<std::string> genres, double score, std::string platform);
+    Game(std::string title, std::vector<std::string> genres, double score, std::string platform,
+         uint64_t id = 0, int releaseYear = 0);
 
     [[nodiscard("Getter")]] std::string get_title() const;
 
@@ -17,7 +20,13 @@ public:
 
     [[nodiscard("Getter")]] std::string get_platform() const;
 
-    // Memory address is compared to resolve ties
+    // MobyGames id, 0 if the record didn't have one
+    [[nodiscard("Getter")]] uint64_t get_id() const;
+
+    // 0 if the release year is unknown
+    [[nodiscard("Getter")]] int get_release_year() const;
+
+    // Ties are broken by platform, then by MobyGames id
     static bool compareTitles(const Game* lhs, const Game* rhs);
 
     static bool compareGenres(const Game* lhs, const Game* rhs);
@@ -26,9 +35,55 @@ public:
 
     static bool comparePlatform(const Game* lhs, const Game* rhs);
 
+    // Single fields without a tie-breaker, for orders on several fields, see compositesort.hpp
+    static std::weak_ordering orderTitles(const Game* lhs, const Game* rhs);
+
+    static std::weak_ordering orderGenres(const Game* lhs, const Game* rhs);
+
+    // Case-insensitive like comparePlatform
+    static std::weak_ordering orderPlatforms(const Game* lhs, const Game* rhs);
+
+    // Members of a game that can own heap memory, see forEachHeapBlock()
+    enum class HeapPart {
+        Title,
+        GenreVector,
+        GenreString,
+        Platform
+    };
+
+    /**
+     * @brief Call visit(part, block, bytes) for every heap allocation owned by the game
+     *
+     * bytes is the size that was requested from the allocator. Strings short enough
+     * for the small string optimization own no allocation. Used by the memory
+     * footprint report, see footprint.hpp.
+     */
+    template<typename Visit>
+    void forEachHeapBlock(Visit&& visit) const {
+        visitString_(HeapPart::Title, title_, visit);
+        if (genres_.capacity() > 0) {
+            visit(HeapPart::GenreVector, static_cast<const void*>(genres_.data()),
+                  genres_.capacity() * sizeof(std::string));
+        }
+        for (const auto& genre : genres_) {
+            visitString_(HeapPart::GenreString, genre, visit);
+        }
+        visitString_(HeapPart::Platform, platform_, visit);
+    }
+
 private:
     std::string title_;
     std::vector<std::string> genres_;
     double score_ = 0.0F;
     std::string platform_;
+    uint64_t id_ = 0;
+    int releaseYear_ = 0;
+
+    template<typename Visit>
+    static void visitString_(const HeapPart part, const std::string& text, Visit& visit) {
+        // An empty string's capacity is the small string buffer, anything larger lives on the heap
+        if (text.capacity() > std::string().capacity()) {
+            visit(part, static_cast<const void*>(text.data()), text.capacity() + 1);
+        }
+    }
 };
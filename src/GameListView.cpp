@@ -0,0 +1,226 @@
+#include "GameListView.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    constexpr unsigned CHARACTER_SIZE_ = 25;
+    // Text starts this far below the top of its row
+    constexpr float ROW_PADDING_ = 25.0F;
+    constexpr float TITLE_X_ = 50.0F;
+    constexpr float RATING_X_ = 475.0F;
+    constexpr float PLATFORM_X_ = 650.0F;
+    constexpr float GENRES_X_ = 950.0F;
+    constexpr float SCROLLBAR_GAP_ = 10.0F;
+    constexpr float SCROLLBAR_WIDTH_ = 12.0F;
+    constexpr float MIN_THUMB_HEIGHT_ = 24.0F;
+    // Pixels per notch of the mouse wheel
+    constexpr double WHEEL_STEP_ = 100.0;
+    // An animated scroll covers 1 - e^(-SCROLL_RATE_ * seconds) of the remaining distance
+    constexpr double SCROLL_RATE_ = 18.0;
+    // Longest frame an animation step accounts for, so the first frame after idling doesn't jump
+    constexpr float MAX_STEP_SECONDS_ = 0.05F;
+}
+
+GameListView::GameListView(const sf::Font& font, const std::vector<Game*>& games, const sf::FloatRect area) :
+    games_(games), area_(area), text_(font, CHARACTER_SIZE_) {}
+
+void GameListView::scrollToRow(const size_t row, const bool smooth) {
+    targetOffset_ = std::clamp(static_cast<double>(row) * ROW_HEIGHT, 0.0, maxOffset_());
+    if (!smooth) {
+        offset_ = targetOffset_;
+    }
+}
+
+void GameListView::scrollBy(const double pixels) {
+    targetOffset_ = std::clamp(targetOffset_ + pixels, 0.0, maxOffset_());
+}
+
+void GameListView::scrollPages(const int pages) {
+    // Whole rows, so that paging lines the rows up with the top again
+    const double rowsPerPage = std::max(1.0F, std::floor(area_.height / ROW_HEIGHT));
+    scrollBy(static_cast<double>(pages) * rowsPerPage * ROW_HEIGHT);
+}
+
+size_t GameListView::getFirstRow() const {
+    if (games_.empty()) {
+        return 0;
+    }
+    return std::min(static_cast<size_t>(offset_ / ROW_HEIGHT), games_.size() - 1);
+}
+
+size_t GameListView::getVisibleRowCount() const {
+    const auto end = static_cast<size_t>(std::ceil((offset_ + area_.height) / ROW_HEIGHT));
+    return std::min(end, games_.size()) - std::min(getFirstRow(), games_.size());
+}
+
+bool GameListView::handleEvent(const sf::Event& event, const sf::RenderWindow& window) {
+    switch (event.type) {
+        case sf::Event::MouseWheelScrolled: {
+            const sf::Vector2f mouse = window.mapPixelToCoords(
+                sf::Vector2i(event.mouseWheelScroll.x, event.mouseWheelScroll.y));
+            if (event.mouseWheelScroll.wheel != sf::Mouse::VerticalWheel ||
+                (!area_.contains(mouse) && !trackBounds_().contains(mouse))) {
+                return false;
+            }
+            scrollBy(-event.mouseWheelScroll.delta * WHEEL_STEP_);
+            return true;
+        }
+        case sf::Event::KeyPressed:
+            switch (event.key.code) {
+                case sf::Keyboard::Up:
+                    scrollBy(-ROW_HEIGHT);
+                    return true;
+                case sf::Keyboard::Down:
+                    scrollBy(ROW_HEIGHT);
+                    return true;
+                case sf::Keyboard::PageUp:
+                    scrollPages(-1);
+                    return true;
+                case sf::Keyboard::PageDown:
+                    scrollPages(1);
+                    return true;
+                case sf::Keyboard::Home:
+                    scrollToRow(0, true);
+                    return true;
+                case sf::Keyboard::End:
+                    scrollToRow(games_.size(), true);
+                    return true;
+                default:
+                    return false;
+            }
+        case sf::Event::MouseButtonPressed: {
+            if (event.mouseButton.button != sf::Mouse::Left) {
+                return false;
+            }
+            const sf::Vector2f mouse = window.mapPixelToCoords(sf::Vector2i(event.mouseButton.x, event.mouseButton.y));
+            const sf::FloatRect thumb = thumbBounds_();
+            if (thumb.contains(mouse)) {
+                dragging_ = true;
+                dragOffset_ = mouse.y - thumb.top;
+                return false;
+            }
+            if (trackBounds_().contains(mouse)) {
+                // Center the thumb on the click and keep dragging from there
+                dragging_ = true;
+                dragOffset_ = thumb.height / 2.0F;
+                dragThumbTo_(mouse.y - dragOffset_);
+                return true;
+            }
+            return false;
+        }
+        case sf::Event::MouseMoved:
+            if (!dragging_) {
+                return false;
+            }
+            dragThumbTo_(window.mapPixelToCoords(sf::Vector2i(event.mouseMove.x, event.mouseMove.y)).y -
+                         dragOffset_);
+            return true;
+        case sf::Event::MouseButtonReleased:
+            dragging_ = false;
+            return false;
+        default:
+            return false;
+    }
+}
+
+bool GameListView::animate(const sf::Time elapsed) {
+    if (offset_ == targetOffset_) {
+        return false;
+    }
+    const double seconds = std::min(elapsed.asSeconds(), MAX_STEP_SECONDS_);
+    offset_ += (targetOffset_ - offset_) * (1.0 - std::exp(-SCROLL_RATE_ * seconds));
+    if (std::abs(targetOffset_ - offset_) < 0.5) {
+        offset_ = targetOffset_;
+    }
+    return offset_ != targetOffset_;
+}
+
+void GameListView::invalidate() {
+    dirty_ = true;
+}
+
+void GameListView::update() {
+    // The games may have changed size since the offsets were set
+    targetOffset_ = std::min(targetOffset_, maxOffset_());
+    offset_ = std::min(offset_, maxOffset_());
+    const size_t firstRow = getFirstRow();
+    const size_t rowCount = getVisibleRowCount();
+    if (!dirty_ && firstRow == builtFirstRow_ && rowCount == builtRowCount_) {
+        return;
+    }
+
+    builtFirstRow_ = firstRow;
+    builtRowCount_ = rowCount;
+
+    // Laid out relative to the top of the first row, draw() moves the batch to the current offset.
+    // Games don't change once loaded, so the cache's strings of a game that was shown before are still right.
+    text_.clear();
+    for (size_t i = 0; i < rowCount; ++i) {
+        const float y = ROW_PADDING_ + ROW_HEIGHT * static_cast<float>(i);
+        const DisplayCache::Strings strings = strings_.get(*games_[firstRow + i]);
+        text_.add(strings.genres, {GENRES_X_, y});
+        text_.add(strings.platform, {PLATFORM_X_, y});
+        text_.add(strings.rating, {RATING_X_, y});
+        text_.add(strings.title, {TITLE_X_, y});
+    }
+    dirty_ = false;
+}
+
+double GameListView::maxOffset_() const {
+    return std::max(0.0, static_cast<double>(games_.size()) * ROW_HEIGHT - area_.height);
+}
+
+sf::FloatRect GameListView::trackBounds_() const {
+    return {area_.left + area_.width + SCROLLBAR_GAP_, area_.top, SCROLLBAR_WIDTH_, area_.height};
+}
+
+sf::FloatRect GameListView::thumbBounds_() const {
+    const sf::FloatRect track = trackBounds_();
+    const double maxOffset = maxOffset_();
+    if (maxOffset <= 0.0) {
+        return track;
+    }
+    const auto contentHeight = static_cast<double>(games_.size()) * ROW_HEIGHT;
+    const float height = std::max(MIN_THUMB_HEIGHT_,
+                                  static_cast<float>(track.height * area_.height / contentHeight));
+    const auto top = static_cast<float>((track.height - height) * (offset_ / maxOffset));
+    return {track.left, track.top + top, track.width, height};
+}
+
+void GameListView::dragThumbTo_(const float y) {
+    const sf::FloatRect track = trackBounds_();
+    const float range = track.height - thumbBounds_().height;
+    const double fraction = range <= 0.0F ? 0.0 : std::clamp((y - track.top) / range, 0.0F, 1.0F);
+    offset_ = targetOffset_ = fraction * maxOffset_();
+}
+
+void GameListView::draw(sf::RenderTarget& target, const sf::RenderStates states) const {
+    // Clip the rows to the list's area with a view that maps it onto the same pixels
+    const sf::View previousView = target.getView();
+    sf::View clipView(area_);
+    const sf::Vector2u size = target.getSize();
+    clipView.setViewport(sf::FloatRect(area_.left / static_cast<float>(size.x), area_.top / static_cast<float>(size.y),
+                                       area_.width / static_cast<float>(size.x),
+                                       area_.height / static_cast<float>(size.y)));
+    target.setView(clipView);
+    sf::RenderStates rowStates = states;
+    // Within a row of the offset, so exact enough as a float however far down the list is
+    const auto shift = static_cast<float>(static_cast<double>(builtFirstRow_) * ROW_HEIGHT - offset_);
+    rowStates.transform.translate(area_.left, area_.top + shift);
+    target.draw(text_, rowStates);
+    target.setView(previousView);
+
+    if (maxOffset_() > 0.0) {
+        const sf::FloatRect track = trackBounds_();
+        const sf::FloatRect thumb = thumbBounds_();
+        sf::RectangleShape trackShape(sf::Vector2f(track.width, track.height));
+        trackShape.setPosition(track.left, track.top);
+        trackShape.setFillColor(sf::Color(0, 0, 0, 50));
+        sf::RectangleShape thumbShape(sf::Vector2f(thumb.width, thumb.height));
+        thumbShape.setPosition(thumb.left, thumb.top);
+        thumbShape.setFillColor(sf::Color(255, 255, 255, 200));
+        target.draw(trackShape, states);
+        target.draw(thumbShape, states);
+    }
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <SFML/Graphics.hpp>
+
+#include "Game.hpp"
+#include "TextBatcher.hpp"
+#include "displaycache.hpp"
+
+/**
+ * @brief Scrolling list of the games in the main window
+ *
+ * Only the rows that intersect the list's area exist at any time, so a frame costs the
+ * same for 3 games as for 100 million. A game's strings are formatted the first time it is
+ * shown and kept in a DisplayCache, and the glyphs of every visible row are drawn with one
+ * draw call through a TextBatcher. The batch is only rebuilt when different rows scroll
+ * into view or the games were reordered, scrolling within the same rows only moves it.
+ *
+ * Scrolls with the mouse wheel, the keyboard (arrows, page up/down, home, end) and a
+ * draggable scrollbar to the right of the list. Wheel and keyboard scrolling is animated,
+ * see animate().
+ */
+class GameListView : public sf::Drawable {
+public:
+    static constexpr float ROW_HEIGHT = 175.0F;
+
+    /**
+     * @param font Font of every row, must outlive the view
+     * @param games The games to show, in display order. Must outlive the view.
+     * @param area Where the list is drawn in the window, the scrollbar goes to the right of it
+     */
+    GameListView(const sf::Font& font, const std::vector<Game*>& games, sf::FloatRect area);
+
+    /**
+     * @brief Scroll so that a row is at the top, or as close to it as the end of the list allows
+     *
+     * @param row Index into the games, i.e. rank - 1
+     * @param smooth Animate the scroll instead of jumping
+     */
+    void scrollToRow(size_t row, bool smooth = false);
+
+    // Scroll by a number of pixels, animated. Negative scrolls up.
+    void scrollBy(double pixels);
+
+    // Scroll by the height of the list, animated. Negative scrolls up.
+    void scrollPages(int pages);
+
+    // Index of the topmost row that is at least partly visible
+    [[nodiscard("Getter")]] size_t getFirstRow() const;
+
+    // Number of rows that are at least partly visible
+    [[nodiscard("Getter")]] size_t getVisibleRowCount() const;
+
+    /**
+     * @brief Scroll on wheel, key and scrollbar events
+     *
+     * @return True if the event changed what the list shows
+     */
+    bool handleEvent(const sf::Event& event, const sf::RenderWindow& window);
+
+    /**
+     * @brief Move an animated scroll along
+     *
+     * @param elapsed Time since the last frame
+     * @return True while the scroll is still moving
+     */
+    bool animate(sf::Time elapsed);
+
+    // The games were sorted, replaced or changed size, every visible row is checked again on the next update
+    void invalidate();
+
+    // Rebuild the rows whose game changed since the last call, nothing if the visible rows are the same
+    void update();
+
+private:
+    const std::vector<Game*>& games_;
+    sf::FloatRect area_;
+    // Pixels scrolled from the top of the first game, double so that offsets stay exact past 2^24 pixels
+    double offset_ = 0.0;
+    double targetOffset_ = 0.0;
+    // Rows of the last update(), the batch is laid out relative to the top of the first one
+    size_t builtFirstRow_ = 0;
+    size_t builtRowCount_ = 0;
+    DisplayCache strings_;
+    TextBatcher text_;
+    bool dirty_ = true;
+    // Grab point within the scrollbar's thumb while it is dragged
+    bool dragging_ = false;
+    float dragOffset_ = 0.0F;
+
+    [[nodiscard("Getter")]] double maxOffset_() const;
+
+    [[nodiscard("Getter")]] sf::FloatRect trackBounds_() const;
+
+    [[nodiscard("Getter")]] sf::FloatRect thumbBounds_() const;
+
+    // Jump so that the thumb's top is at y
+    void dragThumbTo_(float y);
+
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+};
@@ -0,0 +1,68 @@
+#include "TextBatcher.hpp"
+
+namespace {
+    // Same as sf::Text, keeps neighbouring glyphs in the texture from bleeding into the edges of a quad
+    constexpr float PADDING_ = 1.0F;
+}
+
+TextBatcher::TextBatcher(const sf::Font& font, const unsigned characterSize) : font_(font),
+    characterSize_(characterSize), vertices_(sf::Triangles) {}
+
+void TextBatcher::clear() {
+    vertices_.clear();
+}
+
+void TextBatcher::add(const std::string_view text, const sf::Vector2f position, const sf::Color color) {
+    const sf::String string = sf::String::fromUtf8(text.begin(), text.end());
+    const float whitespaceWidth = font_.getGlyph(U' ', characterSize_, false).advance;
+    const float lineSpacing = font_.getLineSpacing(characterSize_);
+
+    // Like sf::Text, the first baseline is one character size below the top
+    float x = position.x;
+    float y = position.y + static_cast<float>(characterSize_);
+    sf::Uint32 previous = 0;
+    for (const sf::Uint32 current : string) {
+        // Skip the \r of \r\n
+        if (current == U'\r') {
+            continue;
+        }
+        x += font_.getKerning(previous, current, characterSize_);
+        previous = current;
+        if (current == U'\n') {
+            x = position.x;
+            y += lineSpacing;
+            continue;
+        }
+        if (current == U' ' || current == U'\t') {
+            x += current == U' ' ? whitespaceWidth : whitespaceWidth * 4.0F;
+            continue;
+        }
+
+        const sf::Glyph& glyph = font_.getGlyph(current, characterSize_, false);
+        const float left = x + glyph.bounds.left - PADDING_;
+        const float top = y + glyph.bounds.top - PADDING_;
+        const float right = x + glyph.bounds.left + glyph.bounds.width + PADDING_;
+        const float bottom = y + glyph.bounds.top + glyph.bounds.height + PADDING_;
+        const float u1 = static_cast<float>(glyph.textureRect.left) - PADDING_;
+        const float v1 = static_cast<float>(glyph.textureRect.top) - PADDING_;
+        const float u2 = static_cast<float>(glyph.textureRect.left + glyph.textureRect.width) + PADDING_;
+        const float v2 = static_cast<float>(glyph.textureRect.top + glyph.textureRect.height) + PADDING_;
+        vertices_.append(sf::Vertex(sf::Vector2f(left, top), color, sf::Vector2f(u1, v1)));
+        vertices_.append(sf::Vertex(sf::Vector2f(right, top), color, sf::Vector2f(u2, v1)));
+        vertices_.append(sf::Vertex(sf::Vector2f(left, bottom), color, sf::Vector2f(u1, v2)));
+        vertices_.append(sf::Vertex(sf::Vector2f(left, bottom), color, sf::Vector2f(u1, v2)));
+        vertices_.append(sf::Vertex(sf::Vector2f(right, top), color, sf::Vector2f(u2, v1)));
+        vertices_.append(sf::Vertex(sf::Vector2f(right, bottom), color, sf::Vector2f(u2, v2)));
+        x += glyph.advance;
+    }
+}
+
+size_t TextBatcher::getGlyphCount() const {
+    return vertices_.getVertexCount() / 6;
+}
+
+void TextBatcher::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    // Glyphs added since the texture last grew are in it too, the texture object stays the same
+    states.texture = &font_.getTexture(characterSize_);
+    target.draw(vertices_, states);
+}
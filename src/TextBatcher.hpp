@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string_view>
+
+#include <SFML/Graphics.hpp>
+
+/**
+ * @brief Many strings of one font and size, drawn with a single draw call
+ *
+ * Glyphs are laid out the way sf::Text lays them out, as two triangles each into one
+ * sf::VertexArray that samples the font's glyph texture for that character size.
+ */
+class TextBatcher : public sf::Drawable {
+public:
+    /**
+     * @param font Font of every string, must outlive the batcher
+     * @param characterSize Size of every string in pixels
+     */
+    TextBatcher(const sf::Font& font, unsigned characterSize);
+
+    // Remove every string
+    void clear();
+
+    /**
+     * @brief Lay out a string, newlines start a new line
+     *
+     * @param text UTF-8 text
+     * @param position Top left of the text, like sf::Text::setPosition
+     * @param color Fill color
+     */
+    void add(std::string_view text, sf::Vector2f position, sf::Color color = sf::Color::White);
+
+    // Number of glyphs laid out since the last clear()
+    [[nodiscard("Getter")]] size_t getGlyphCount() const;
+
+private:
+    const sf::Font& font_;
+    unsigned characterSize_;
+    sf::VertexArray vertices_;
+
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+};
@@ -1,41 +1,324 @@
 #include "TextureManager.hpp"
-#include <filesystem>
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#include "trace.hpp"
+
+namespace {
+    // Transparent pixels between packed images, so neighbours don't bleed into each other when sampled
+    constexpr int PADDING_ = 2;
+    // Pages are at least this wide unless the GPU can't do it, wide enough for several small images per shelf
+    constexpr unsigned MIN_PAGE_WIDTH_ = 2048;
+
+    std::filesystem::path cacheDirectory_() {
+        std::error_code error;
+        const std::filesystem::path temp = std::filesystem::temp_directory_path(error);
+        return error ? std::filesystem::path() : temp / "GameSort-atlas";
+    }
+}
 
 TextureManager* TextureManager::instance_ = nullptr;
+std::future<TextureManager::PreparedAtlas> TextureManager::preloaded_;
+std::string TextureManager::preloadedPath_;
+unsigned TextureManager::preloadedMaxSize_ = 0;
 
-TextureManager* TextureManager::getInstance(const std::string& directoryPath) {
+void TextureManager::preload(const std::string& directoryPath, const unsigned maxTextureSize) {
+    if (instance_ || preloaded_.valid()) {
+        return;
+    }
+    preloadedPath_ = directoryPath;
+    preloadedMaxSize_ = maxTextureSize;
+    preloaded_ = std::async(std::launch::async, &TextureManager::prepareAtlas, directoryPath, maxTextureSize);
+}
+
+TextureManager* TextureManager::getInstance(const std::string& directoryPath, const LoadMode mode) {
     if (!instance_) {
-        instance_ = new TextureManager(directoryPath);
+        instance_ = new TextureManager(directoryPath, mode);
     }
     return instance_;
 }
 
-TextureManager::TextureManager(const std::string& directoryPath) {
-    loadTextures(directoryPath);
+TextureManager::TextureManager(const std::string& directoryPath, const LoadMode mode) {
+    loadTextures(directoryPath, mode);
 }
 
-void TextureManager::loadTextures(const std::string& texturePath) {
+void TextureManager::loadTextures(const std::string& texturePath, const LoadMode mode) {
+    const trace::Span span("load textures", texturePath);
+    if (mode == LoadMode::Lazy) {
+        for (auto& source : findSources(texturePath)) {
+            pendingFiles.insert_or_assign(std::move(source.name), std::move(source.path));
+        }
+        if (pendingFiles.empty()) {
+            throw std::runtime_error("Textures missing, aborting!");
+        }
+        return;
+    }
+
+    // A preload of another directory is still waited for, its threads can't be abandoned
+    PreparedAtlas prepared;
+    if (preloaded_.valid()) {
+        const trace::Span waitSpan("wait for preloaded atlas");
+        prepared = preloaded_.get();
+    }
+    const unsigned maxTextureSize = sf::Texture::getMaximumSize();
+    if (preloadedPath_ != texturePath || preloadedMaxSize_ != maxTextureSize || prepared.pageImages.empty()) {
+        prepared = prepareAtlas(texturePath, maxTextureSize);
+    }
+
+    // The only part that needs the GL context, and so the only part left on this thread
+    for (const auto& pageImage : prepared.pageImages) {
+        const trace::Span uploadSpan("upload atlas");
+        pages.emplace_back();
+        if (!pages.back().loadFromImage(pageImage)) {
+            throw std::runtime_error("Unable to create the texture atlas, aborting!");
+        }
+    }
+    for (const auto& source : prepared.sources) {
+        regions.insert_or_assign(source.name, Region{&pages[source.page], source.rect});
+    }
+    if (regions.empty()) {
+        throw std::runtime_error("Textures missing, aborting!");
+    }
+}
+
+std::vector<TextureManager::Source> TextureManager::findSources(const std::string& texturePath) {
+    std::vector<Source> sources;
     const std::filesystem::recursive_directory_iterator iter(texturePath);
     for (const auto& file : iter) {
         if (file.is_regular_file() && (file.path().extension() == ".png" || file.path().extension() == ".jpg")) {
-            sf::Texture texture;
-            if (!texture.loadFromFile(file.path().string())) {
-                continue;
+            sources.push_back({file.path().filename().replace_extension().string(), file.path()});
+        }
+    }
+    // Directory order isn't specified, sorting keeps the packing and the cache signature stable
+    std::ranges::sort(sources, {}, &Source::path);
+    return sources;
+}
+
+TextureManager::PreparedAtlas TextureManager::prepareAtlas(const std::string& texturePath,
+                                                          const unsigned maxTextureSize) {
+    const trace::Span span("prepare atlas", texturePath);
+    PreparedAtlas prepared;
+    prepared.sources = findSources(texturePath);
+    const std::string signature = atlasSignature(prepared.sources);
+    if (loadCachedAtlas(prepared, signature, maxTextureSize)) {
+        return prepared;
+    }
+
+    std::vector<std::filesystem::path> paths;
+    for (const auto& source : prepared.sources) {
+        paths.push_back(source.path);
+    }
+    std::vector<sf::Image> images = decodeImages(paths);
+    for (size_t i = 0; i < images.size(); ++i) {
+        prepared.sources[i].image = std::move(images[i]);
+    }
+    // Images that failed to decode have no size and are left out
+    std::erase_if(prepared.sources, [](const Source& source) {
+        return source.image.getSize().x == 0 || source.image.getSize().y == 0;
+    });
+    prepared.pageImages = packAtlas(prepared.sources, maxTextureSize);
+    saveCachedAtlas(prepared, signature);
+    // The pixels are in the pages now
+    for (auto& source : prepared.sources) {
+        source.image = sf::Image();
+    }
+    return prepared;
+}
+
+std::vector<sf::Image> TextureManager::decodeImages(const std::vector<std::filesystem::path>& paths) {
+    std::vector<sf::Image> images(paths.size());
+    // Decoding is independent per file and doesn't touch the GL context, each worker takes the next file
+    std::atomic<size_t> next = 0;
+    const auto decode = [&] {
+        for (size_t i = next++; i < paths.size(); i = next++) {
+            const trace::Span textureSpan("load texture", paths[i].filename().string());
+            if (!images[i].loadFromFile(paths[i].string())) {
+                images[i] = sf::Image();
             }
-            textures.emplace(file.path().filename().replace_extension().string(), texture);
         }
+    };
+    const size_t threadCount = std::min<size_t>(std::max(1U, std::thread::hardware_concurrency()), paths.size());
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < threadCount; ++i) {
+        workers.emplace_back(decode);
     }
-    if (textures.empty()) {
-        throw std::runtime_error("Textures missing, aborting!");
+    decode();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return images;
+}
+
+std::vector<sf::Image> TextureManager::packAtlas(std::vector<Source>& sources, const unsigned maxTextureSize) {
+    const trace::Span span("pack atlas");
+    const auto maxSize = static_cast<int>(maxTextureSize);
+    int pageWidth = static_cast<int>(MIN_PAGE_WIDTH_);
+    for (const auto& source : sources) {
+        pageWidth = std::max(pageWidth, static_cast<int>(source.image.getSize().x) + PADDING_);
+    }
+    pageWidth = std::min(pageWidth, maxSize);
+
+    // Shelf packing: tallest first, left to right along a shelf, a new shelf below when one is full
+    // and a new page when the page is full
+    std::vector<Source*> order;
+    for (auto& source : sources) {
+        const sf::Vector2u size = source.image.getSize();
+        if (static_cast<int>(size.x) > maxSize || static_cast<int>(size.y) > maxSize) {
+            throw std::runtime_error(source.path.string() + " is larger than the largest texture the GPU supports");
+        }
+        order.push_back(&source);
+    }
+    std::ranges::stable_sort(order, std::greater<>(), [](const Source* source) {
+        return source->image.getSize().y;
+    });
+
+    std::vector<int> pageHeights(1, 0);
+    int shelfX = 0;
+    int shelfY = 0;
+    int shelfHeight = 0;
+    for (Source* source : order) {
+        const auto width = static_cast<int>(source->image.getSize().x);
+        const auto height = static_cast<int>(source->image.getSize().y);
+        if (shelfX + width > pageWidth) {
+            shelfY += shelfHeight + PADDING_;
+            shelfX = 0;
+            shelfHeight = 0;
+        }
+        if (shelfY + height > maxSize) {
+            pageHeights.push_back(0);
+            shelfX = 0;
+            shelfY = 0;
+            shelfHeight = 0;
+        }
+        source->page = pageHeights.size() - 1;
+        source->rect = sf::IntRect(shelfX, shelfY, width, height);
+        shelfX += width + PADDING_;
+        shelfHeight = std::max(shelfHeight, height);
+        pageHeights.back() = std::max(pageHeights.back(), shelfY + height);
     }
+
+    std::vector<sf::Image> pageImages(pageHeights.size());
+    for (size_t page = 0; page < pageImages.size(); ++page) {
+        const auto pageHeight = static_cast<unsigned>(std::max(1, pageHeights[page]));
+        pageImages[page].create(static_cast<unsigned>(pageWidth), pageHeight, sf::Color::Transparent);
+    }
+    for (const auto& source : sources) {
+        pageImages[source.page].copy(source.image, static_cast<unsigned>(source.rect.left),
+                                     static_cast<unsigned>(source.rect.top));
+    }
+    return pageImages;
 }
 
-sf::Texture& TextureManager::getTexture(const std::string& textureName) {
-    return textures.at(textureName);
+std::string TextureManager::atlasSignature(const std::vector<Source>& sources) {
+    std::ostringstream signature;
+    for (const auto& source : sources) {
+        std::error_code error;
+        const auto size = std::filesystem::file_size(source.path, error);
+        const auto time = std::filesystem::last_write_time(source.path, error).time_since_epoch().count();
+        signature << source.path.filename().string() << ' ' << size << ' ' << time << ';';
+    }
+    return signature.str();
+}
+
+bool TextureManager::loadCachedAtlas(PreparedAtlas& prepared, const std::string& signature,
+                                     const unsigned maxTextureSize) {
+    const std::filesystem::path directory = cacheDirectory_();
+    std::ifstream index(directory / "atlas.txt");
+    std::string cachedSignature;
+    if (directory.empty() || !index.is_open() || !std::getline(index, cachedSignature) ||
+        cachedSignature != signature) {
+        return false;
+    }
+
+    // One line per image: name, page, left, top, width, height
+    std::unordered_map<std::string, std::pair<size_t, sf::IntRect>> cachedRegions;
+    size_t pageCount = 0;
+    std::string name;
+    size_t page = 0;
+    sf::IntRect rect;
+    while (index >> name >> page >> rect.left >> rect.top >> rect.width >> rect.height) {
+        cachedRegions.insert_or_assign(name, std::make_pair(page, rect));
+        pageCount = std::max(pageCount, page + 1);
+    }
+    for (auto& source : prepared.sources) {
+        const auto cached = cachedRegions.find(source.name);
+        if (cached == cachedRegions.end()) {
+            return false;
+        }
+        source.page = cached->second.first;
+        source.rect = cached->second.second;
+    }
+
+    const trace::Span span("load cached atlas");
+    std::vector<std::filesystem::path> paths;
+    for (size_t i = 0; i < pageCount; ++i) {
+        paths.push_back(directory / ("atlas" + std::to_string(i) + ".png"));
+    }
+    std::vector<sf::Image> pageImages = decodeImages(paths);
+    // Pages packed for a GPU with larger textures are packed again
+    for (const auto& pageImage : pageImages) {
+        if (pageImage.getSize().x == 0 || pageImage.getSize().x > maxTextureSize ||
+            pageImage.getSize().y > maxTextureSize) {
+            return false;
+        }
+    }
+    prepared.pageImages = std::move(pageImages);
+    return true;
+}
+
+void TextureManager::saveCachedAtlas(const PreparedAtlas& prepared, const std::string& signature) {
+    const trace::Span span("save atlas cache");
+    const std::filesystem::path directory = cacheDirectory_();
+    if (directory.empty()) {
+        return;
+    }
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    // Removed first, so an interrupted save leaves no index that points at missing or newer pages
+    std::filesystem::remove(directory / "atlas.txt", error);
+    for (size_t i = 0; i < prepared.pageImages.size(); ++i) {
+        if (!prepared.pageImages[i].saveToFile((directory / ("atlas" + std::to_string(i) + ".png")).string())) {
+            std::cerr << "Couldn't cache the texture atlas in " << directory.string() << '\n';
+            return;
+        }
+    }
+    std::ofstream index(directory / "atlas.txt");
+    index << signature << '\n';
+    for (const auto& source : prepared.sources) {
+        index << source.name << ' ' << source.page << ' ' << source.rect.left << ' ' << source.rect.top << ' '
+              << source.rect.width << ' ' << source.rect.height << '\n';
+    }
+}
+
+const TextureManager::Region& TextureManager::getRegion(const std::string& textureName) {
+    const auto region = regions.find(textureName);
+    if (region != regions.end()) {
+        return region->second;
+    }
+    const auto file = pendingFiles.find(textureName);
+    if (file == pendingFiles.end()) {
+        throw std::out_of_range("No texture named " + textureName);
+    }
+    const trace::Span span("load texture", file->second.filename().string());
+    sf::Texture& texture = pages.emplace_back();
+    if (!texture.loadFromFile(file->second.string())) {
+        pages.pop_back();
+        throw std::runtime_error("Unable to load " + file->second.string() + ", aborting!");
+    }
+    pendingFiles.erase(file);
+    const auto size = texture.getSize();
+    return regions.insert_or_assign(textureName, Region{&texture, sf::IntRect(0, 0, static_cast<int>(size.x),
+                                                                               static_cast<int>(size.y))})
+        .first->second;
 }
 
 TextureManager::~TextureManager() {
-    textures.clear();
+    regions.clear();
+    pages.clear();
     delete instance_;
     instance_ = nullptr;
 }
@@ -1,10 +1,38 @@
 #pragma once
+#include <deque>
+#include <filesystem>
+#include <future>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <SFML/Graphics.hpp>
 
+/**
+ * @brief Loads every image under the resource directory into as few atlas textures as possible
+ *
+ * Images are packed into shelves of a texture at load time, so sprites from the same atlas
+ * page can be drawn together with one texture bind. The packed pages are cached in the
+ * system's temporary directory and reused while the images keep their sizes and times.
+ *
+ * Decoding and packing don't need the GPU, so they run on worker threads, one image per
+ * thread at a time, and can start with preload() long before the first getInstance().
+ * Only the upload of the finished pages happens on the thread that calls getInstance().
+ */
 class TextureManager {
 public:
+    // Where an image ended up: its atlas page and the rectangle it covers in pixels
+    struct Region {
+        const sf::Texture* texture;
+        sf::IntRect rect;
+    };
+
+    enum class LoadMode {
+        // Decode every image up front and pack them into atlas pages
+        Atlas,
+        // Decode each image into its own texture on its first getRegion(), images nobody asks for are never read
+        Lazy
+    };
+
     // Singleton, delete copy constructor and copy assignment operator
     TextureManager(TextureManager& rhs) = delete;
 
@@ -14,18 +42,85 @@ public:
 
     void operator=(const TextureManager&& rhs) = delete;
 
-    sf::Texture& getTexture(const std::string& textureName);
+    /**
+     * @brief Region of an image by its file name without extension, e.g. "arrowNext"
+     *
+     * Must be called from the thread that created the instance, in lazy mode it may create a texture.
+     */
+    const Region& getRegion(const std::string& textureName);
+
+    /**
+     * @brief Start decoding and packing the atlas of a directory on worker threads
+     *
+     * The next getInstance() with the same directory in atlas mode picks the result up
+     * and only has to upload it. Does nothing if the instance already exists.
+     *
+     * @param maxTextureSize sf::Texture::getMaximumSize(), queried on the render thread since it needs a GL context
+     */
+    static void preload(const std::string& directoryPath, unsigned maxTextureSize);
 
-    static TextureManager* getInstance(const std::string& directoryPath);
+    /**
+     * @param directoryPath Directory searched recursively for .png and .jpg images
+     * @param mode How the images are loaded, only used by the call that creates the instance
+     */
+    static TextureManager* getInstance(const std::string& directoryPath, LoadMode mode = LoadMode::Atlas);
 
     ~TextureManager();
 
 private:
+    // An image file that goes into the atlas, and where it was packed
+    struct Source {
+        std::string name;
+        std::filesystem::path path;
+        sf::Image image;
+        size_t page = 0;
+        sf::IntRect rect;
+    };
+
+    // Everything about the atlas that doesn't need the GPU: where each image went and the page pixels
+    struct PreparedAtlas {
+        std::vector<Source> sources;
+        std::vector<sf::Image> pageImages;
+    };
+
     static TextureManager* instance_;
 
-    std::unordered_map<std::string, sf::Texture> textures;
+    static std::future<PreparedAtlas> preloaded_;
+
+    static std::string preloadedPath_;
+
+    static unsigned preloadedMaxSize_;
+
+    // Atlas pages, or one texture per image in lazy mode. A deque so that the regions' pointers stay valid.
+    std::deque<sf::Texture> pages;
+
+    std::unordered_map<std::string, Region> regions;
+
+    // Lazy mode: images that weren't asked for yet, by name
+    std::unordered_map<std::string, std::filesystem::path> pendingFiles;
+
+    TextureManager(const std::string& directoryPath, LoadMode mode);
+
+    void loadTextures(const std::string& texturePath, LoadMode mode);
+
+    // Every image file under the directory, sorted by path
+    static std::vector<Source> findSources(const std::string& texturePath);
+
+    // Decode, pack and cache the atlas, or read it from the cache. Safe to run on any thread, no page is larger
+    // than maxTextureSize in either direction
+    static PreparedAtlas prepareAtlas(const std::string& texturePath, unsigned maxTextureSize);
+
+    // Decode every file into the image at the same index on worker threads, failures leave an empty image
+    static std::vector<sf::Image> decodeImages(const std::vector<std::filesystem::path>& paths);
+
+    // Pack the decoded sources into page images, filling in their page and rect
+    static std::vector<sf::Image> packAtlas(std::vector<Source>& sources, unsigned maxTextureSize);
+
+    // Identifies the image files by name, size and modification time
+    static std::string atlasSignature(const std::vector<Source>& sources);
 
-    explicit TextureManager(const std::string& directoryPath);
+    // Fails if the cache is stale or one of its pages is larger than maxTextureSize
+    static bool loadCachedAtlas(PreparedAtlas& prepared, const std::string& signature, unsigned maxTextureSize);
 
-    void loadTextures(const std::string& texturePath);
+    static void saveCachedAtlas(const PreparedAtlas& prepared, const std::string& signature);
 };
@@ -0,0 +1,272 @@
+#include "allocprofile.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <sstream>
+
+#ifdef GAMESORT_INSTRUMENT
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+#include "instrument.hpp"
+#endif
+
+namespace {
+    // Escape a phase name for a JSON string, names are short ASCII labels
+    std::string escapeName_(const std::string& name) {
+        std::string escaped;
+        for (const char c : name) {
+            if (c == '"' || c == '\\') {
+                escaped += '\\';
+            }
+            escaped += c;
+        }
+        return escaped;
+    }
+
+#ifdef GAMESORT_INSTRUMENT
+    constexpr size_t MAX_PHASES_ = 64;
+    constexpr size_t MAX_NAME_LENGTH_ = 47;
+    // Every allocation is prefixed with its size, so that unsized deletes know how much is freed
+    constexpr size_t HEADER_SIZE_ = alignof(std::max_align_t);
+
+    // Counters of one phase. Everything here is constant-initialized and trivially destructible,
+    // so it is usable by allocations made before main() and after static destructors ran.
+    struct PhaseSlot_ {
+        char name[MAX_NAME_LENGTH_ + 1];
+        std::atomic<uint64_t> allocations;
+        std::atomic<uint64_t> bytes;
+        std::atomic<uint64_t> frees;
+        std::atomic<uint64_t> freedBytes;
+        std::atomic<uint64_t> peakLiveBytes;
+        std::atomic<int64_t> retainedBytes;
+        std::atomic<uint64_t> activations;
+        std::array<std::atomic<uint64_t>, heap::SIZE_CLASS_COUNT> sizeClasses;
+    };
+
+    // Slot 0 collects the allocations made outside of any phase, and the phases past MAX_PHASES_
+    PhaseSlot_ slots_[MAX_PHASES_] = {{"unattributed"}};
+    size_t slotCount_ = 1;
+    std::mutex slotsMutex_;
+    std::atomic<uint64_t> liveBytes_{0};
+    thread_local size_t currentPhase_ = 0;
+
+    size_t sizeClassOf_(const size_t size) {
+        // 0 holds up to 16 bytes, 1 up to 32 and so on, the last one everything larger than 1 MiB
+        const auto width = static_cast<size_t>(std::bit_width(size <= 1 ? 0 : size - 1));
+        return std::min(width < 4 ? 0 : width - 4, heap::SIZE_CLASS_COUNT - 1);
+    }
+
+    void raisePeak_(PhaseSlot_& slot, const uint64_t live) {
+        uint64_t peak = slot.peakLiveBytes.load(std::memory_order_relaxed);
+        while (live > peak && !slot.peakLiveBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+    }
+
+    size_t findOrAddPhase_(const std::string& name) {
+        const std::scoped_lock lock(slotsMutex_);
+        const std::string truncated = name.substr(0, MAX_NAME_LENGTH_);
+        for (size_t i = 1; i < slotCount_; ++i) {
+            if (truncated == slots_[i].name) {
+                return i;
+            }
+        }
+        if (slotCount_ == MAX_PHASES_) {
+            return 0;
+        }
+        std::memcpy(slots_[slotCount_].name, truncated.c_str(), truncated.size() + 1);
+        return slotCount_++;
+    }
+
+    void recordAllocation_(const size_t size) {
+        const uint64_t live = liveBytes_.fetch_add(size, std::memory_order_relaxed) + size;
+        PhaseSlot_& slot = slots_[currentPhase_];
+        slot.allocations.fetch_add(1, std::memory_order_relaxed);
+        slot.bytes.fetch_add(size, std::memory_order_relaxed);
+        slot.sizeClasses[sizeClassOf_(size)].fetch_add(1, std::memory_order_relaxed);
+        raisePeak_(slot, live);
+        if (instr::trackingAllocations()) {
+            ++instr::counters().allocations;
+            instr::counters().allocatedBytes += size;
+        }
+    }
+
+    void recordFree_(const size_t size) {
+        liveBytes_.fetch_sub(size, std::memory_order_relaxed);
+        PhaseSlot_& slot = slots_[currentPhase_];
+        slot.frees.fetch_add(1, std::memory_order_relaxed);
+        slot.freedBytes.fetch_add(size, std::memory_order_relaxed);
+    }
+#endif
+}
+
+namespace heap {
+    size_t sizeClassLimit(const size_t sizeClass) {
+        return sizeClass + 1 >= SIZE_CLASS_COUNT ? 0 : size_t{16} << sizeClass;
+    }
+
+#ifdef GAMESORT_INSTRUMENT
+    Phase::Phase(const std::string& name) : index_(findOrAddPhase_(name)), previous_(currentPhase_),
+                                            liveAtStart_(liveBytes_.load(std::memory_order_relaxed)) {
+        currentPhase_ = index_;
+        slots_[index_].activations.fetch_add(1, std::memory_order_relaxed);
+        raisePeak_(slots_[index_], liveAtStart_);
+    }
+
+    Phase::~Phase() {
+        end();
+    }
+
+    void Phase::end() {
+        if (ended_) {
+            return;
+        }
+        ended_ = true;
+        const uint64_t live = liveBytes_.load(std::memory_order_relaxed);
+        slots_[index_].retainedBytes.fetch_add(static_cast<int64_t>(live) - static_cast<int64_t>(liveAtStart_),
+                                               std::memory_order_relaxed);
+        currentPhase_ = previous_;
+    }
+
+    std::vector<PhaseStats> phaseStats() {
+        const std::scoped_lock lock(slotsMutex_);
+        std::vector<PhaseStats> stats;
+        for (size_t i = 0; i < slotCount_; ++i) {
+            const PhaseSlot_& slot = slots_[i];
+            PhaseStats phase;
+            phase.name = slot.name;
+            phase.allocations = slot.allocations.load(std::memory_order_relaxed);
+            phase.bytes = slot.bytes.load(std::memory_order_relaxed);
+            phase.frees = slot.frees.load(std::memory_order_relaxed);
+            phase.freedBytes = slot.freedBytes.load(std::memory_order_relaxed);
+            phase.peakLiveBytes = slot.peakLiveBytes.load(std::memory_order_relaxed);
+            phase.retainedBytes = slot.retainedBytes.load(std::memory_order_relaxed);
+            phase.activations = slot.activations.load(std::memory_order_relaxed);
+            for (size_t sizeClass = 0; sizeClass < SIZE_CLASS_COUNT; ++sizeClass) {
+                phase.sizeClasses[sizeClass] = slot.sizeClasses[sizeClass].load(std::memory_order_relaxed);
+            }
+            stats.push_back(std::move(phase));
+        }
+        return stats;
+    }
+
+    void resetPhaseStats() {
+        const std::scoped_lock lock(slotsMutex_);
+        for (size_t i = 0; i < slotCount_; ++i) {
+            PhaseSlot_& slot = slots_[i];
+            for (auto* counter : {&slot.allocations, &slot.bytes, &slot.frees, &slot.freedBytes,
+                                  &slot.peakLiveBytes, &slot.activations}) {
+                counter->store(0, std::memory_order_relaxed);
+            }
+            slot.retainedBytes.store(0, std::memory_order_relaxed);
+            for (auto& count : slot.sizeClasses) {
+                count.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+#else
+    std::vector<PhaseStats> phaseStats() {
+        return {};
+    }
+
+    void resetPhaseStats() {}
+#endif
+
+    void printReport(std::ostream& out) {
+        const std::vector<PhaseStats> stats = phaseStats();
+        if (stats.empty()) {
+            return;
+        }
+        char line[256];
+        std::snprintf(line, sizeof(line), "%-28s %8s %12s %14s %12s %14s %14s\n", "phase", "runs", "allocations",
+                      "bytes", "frees", "peak live", "retained");
+        out << line;
+        for (const auto& phase : stats) {
+            if (phase.allocations == 0 && phase.frees == 0) {
+                continue;
+            }
+            std::snprintf(line, sizeof(line), "%-28s %8llu %12llu %14llu %12llu %14llu %14lld\n",
+                          phase.name.c_str(), static_cast<unsigned long long>(phase.activations),
+                          static_cast<unsigned long long>(phase.allocations),
+                          static_cast<unsigned long long>(phase.bytes), static_cast<unsigned long long>(phase.frees),
+                          static_cast<unsigned long long>(phase.peakLiveBytes),
+                          static_cast<long long>(phase.retainedBytes));
+            out << line;
+            // Histogram of the size classes that were used, e.g. "<=32: 1200"
+            out << "    ";
+            for (size_t sizeClass = 0; sizeClass < SIZE_CLASS_COUNT; ++sizeClass) {
+                if (phase.sizeClasses[sizeClass] == 0) {
+                    continue;
+                }
+                const size_t limit = sizeClassLimit(sizeClass);
+                out << (limit == 0 ? ">" + std::to_string(sizeClassLimit(sizeClass - 1))
+                                   : "<=" + std::to_string(limit))
+                    << ": " << phase.sizeClasses[sizeClass] << "  ";
+            }
+            out << '\n';
+        }
+    }
+
+    std::string reportJson() {
+        std::ostringstream json;
+        json << '[';
+        bool first = true;
+        for (const auto& phase : phaseStats()) {
+            if (phase.allocations == 0 && phase.frees == 0) {
+                continue;
+            }
+            json << (first ? "\n" : ",\n") << "    {\"phase\": \"" << escapeName_(phase.name) << "\", \"runs\": "
+                 << phase.activations << ", \"allocations\": " << phase.allocations << ", \"bytes\": "
+                 << phase.bytes << ", \"frees\": " << phase.frees << ", \"freed_bytes\": " << phase.freedBytes
+                 << ", \"peak_live_bytes\": " << phase.peakLiveBytes << ", \"retained_bytes\": "
+                 << phase.retainedBytes << ", \"size_classes\": {";
+            bool firstClass = true;
+            for (size_t sizeClass = 0; sizeClass < SIZE_CLASS_COUNT; ++sizeClass) {
+                if (phase.sizeClasses[sizeClass] == 0) {
+                    continue;
+                }
+                // Keyed by the largest size in the class, "inf" for the last one
+                const size_t limit = sizeClassLimit(sizeClass);
+                json << (firstClass ? "" : ", ") << '"' << (limit == 0 ? "inf" : std::to_string(limit))
+                     << "\": " << phase.sizeClasses[sizeClass];
+                firstClass = false;
+            }
+            json << "}}";
+            first = false;
+        }
+        json << (first ? "]" : "\n  ]");
+        return json.str();
+    }
+}
+
+#ifdef GAMESORT_INSTRUMENT
+// Replacing the throwing single-object operator new and delete covers every other form, whose default versions
+// forward to these. Aligned new and delete aren't replaced and keep bypassing the profiler.
+void* operator new(const std::size_t size) {
+    auto* memory = static_cast<unsigned char*>(std::malloc(size + HEADER_SIZE_));
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    std::memcpy(memory, &size, sizeof(size));
+    recordAllocation_(size);
+    return memory + HEADER_SIZE_;
+}
+
+void operator delete(void* memory) noexcept {
+    if (memory == nullptr) {
+        return;
+    }
+    auto* block = static_cast<unsigned char*>(memory) - HEADER_SIZE_;
+    std::size_t size;
+    std::memcpy(&size, block, sizeof(size));
+    recordFree_(size);
+    std::free(block);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    ::operator delete(memory);
+}
+#endif
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*
+ * Allocation profiler: counts heap allocations by the phase of the program they happen in.
+ *
+ * Compiled in with the GAMESORT_INSTRUMENT CMake option, which replaces the global operator new and delete
+ * (see allocprofile.cpp). Without it heap::Phase is an empty class and the reports are empty, so release builds
+ * keep the default allocator and pay nothing.
+ */
+namespace heap {
+#ifdef GAMESORT_INSTRUMENT
+    constexpr bool ENABLED = true;
+#else
+    constexpr bool ENABLED = false;
+#endif
+
+    // Size classes are powers of two: up to 16 bytes, up to 32 bytes, ... up to 1 MiB, then everything larger
+    constexpr size_t SIZE_CLASS_COUNT = 18;
+
+    // Largest size in a size class, 0 for the last, unbounded one
+    size_t sizeClassLimit(size_t sizeClass);
+
+    /**
+     * @brief Allocations made while a phase was the innermost active phase of its thread
+     *
+     * peakLiveBytes is the most heap in use by the whole process when the phase began
+     * or made an allocation. retainedBytes is how much more was in use when it ended
+     * than when it began, summed over every run, so it shows what a phase leaves behind.
+     */
+    struct PhaseStats {
+        std::string name;
+        uint64_t allocations = 0;
+        uint64_t bytes = 0;
+        uint64_t frees = 0;
+        uint64_t freedBytes = 0;
+        uint64_t peakLiveBytes = 0;
+        int64_t retainedBytes = 0;
+        uint64_t activations = 0;
+        std::array<uint64_t, SIZE_CLASS_COUNT> sizeClasses{};
+    };
+
+#ifdef GAMESORT_INSTRUMENT
+    /**
+     * @brief Attributes the allocations of the current thread to a named phase until it ends
+     *
+     * Phases nest, allocations count towards the innermost one. A phase ends when
+     * end() is called or it goes out of scope, whichever is first. Phases with the
+     * same name share their statistics.
+     */
+    class Phase {
+    public:
+        explicit Phase(const std::string& name);
+
+        ~Phase();
+
+        Phase(const Phase&) = delete;
+
+        Phase& operator=(const Phase&) = delete;
+
+        void end();
+
+    private:
+        size_t index_;
+        size_t previous_;
+        uint64_t liveAtStart_;
+        bool ended_ = false;
+    };
+#else
+    class Phase {
+    public:
+        explicit Phase(const std::string&) {}
+
+        // Not defaulted, so that a phase that is never ended explicitly doesn't warn as unused
+        ~Phase() {}
+
+        Phase(const Phase&) = delete;
+
+        Phase& operator=(const Phase&) = delete;
+
+        void end() {}
+    };
+#endif
+
+    // Statistics of every phase that has run, in the order they first ran
+    std::vector<PhaseStats> phaseStats();
+
+    // Forget every phase's statistics, e.g. between benchmark runs
+    void resetPhaseStats();
+
+    // Print a table of every phase and its size class histogram
+    void printReport(std::ostream& out);
+
+    // Write every phase as a JSON array of objects
+    std::string reportJson();
+}
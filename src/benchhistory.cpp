@@ -0,0 +1,336 @@
+#include "benchhistory.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <numeric>
+#include <stdexcept>
+
+#include "../lib/simdjson.h"
+
+// GAMESORT_COMMIT, GAMESORT_COMPILER and GAMESORT_FLAGS, generated by cmake/BuildInfo.cmake on every build
+#include "buildinfo.hpp"
+
+namespace {
+    // Largest sample size the exact distribution of U is computed for, larger ones use the normal approximation
+    constexpr size_t EXACT_LIMIT_ = 25;
+
+    std::string cpuModel_() {
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(cpuinfo, line)) {
+            if (line.starts_with("model name")) {
+                const size_t colon = line.find(':');
+                if (colon != std::string::npos && colon + 2 <= line.size()) {
+                    return line.substr(colon + 2);
+                }
+            }
+        }
+        return "unknown";
+    }
+
+    // Probability that a standard normal variable is larger than z
+    double normalTail_(const double z) {
+        return 0.5 * std::erfc(z / std::sqrt(2.0));
+    }
+
+    // z such that normalTail_(z) == tail, by bisection, plenty fast for a handful of calls
+    double normalQuantile_(const double tail) {
+        double low = 0.0;
+        double high = 10.0;
+        for (int i = 0; i < 100; ++i) {
+            const double mid = (low + high) / 2.0;
+            (normalTail_(mid) > tail ? low : high) = mid;
+        }
+        return (low + high) / 2.0;
+    }
+
+    /**
+     * Number of orderings of n and m distinct values for every U from 0 to n * m, the
+     * coefficients of the Gaussian binomial (n + m choose n). counts(i, j) = counts(i - 1, j)
+     * shifted by j, for when the largest value is from the first sample, plus counts(i, j - 1).
+     */
+    std::vector<double> exactUCounts_(const size_t n, const size_t m) {
+        std::vector<std::vector<std::vector<double>>> counts(n + 1, std::vector<std::vector<double>>(m + 1));
+        for (size_t i = 0; i <= n; ++i) {
+            for (size_t j = 0; j <= m; ++j) {
+                counts[i][j].assign(i * j + 1, 0.0);
+                if (i == 0 || j == 0) {
+                    counts[i][j][0] = 1.0;
+                    continue;
+                }
+                for (size_t u = 0; u < counts[i - 1][j].size(); ++u) {
+                    counts[i][j][u + j] += counts[i - 1][j][u];
+                }
+                for (size_t u = 0; u < counts[i][j - 1].size(); ++u) {
+                    counts[i][j][u] += counts[i][j - 1][u];
+                }
+            }
+        }
+        return counts[n][m];
+    }
+
+    std::string benchKey_(const BenchResult& result) {
+        return std::string(result.algorithm) + ' ' + result.comparator + ' ' + result.input + ' ' +
+               std::to_string(result.elements);
+    }
+
+    std::string readString_(simdjson::ondemand::object& object, const char* key) {
+        std::string_view value;
+        if (object[key].get_string().get(value) != simdjson::SUCCESS) {
+            return "";
+        }
+        return std::string(value);
+    }
+}
+
+BuildInfo currentBuildInfo() {
+    return {GAMESORT_COMMIT, GAMESORT_COMPILER, instr::ENABLED ? GAMESORT_FLAGS " (instrumented)" : GAMESORT_FLAGS,
+            cpuModel_()};
+}
+
+std::string buildInfoJson(const BuildInfo& build) {
+    return "{\"commit\": \"" + escapeJson(build.commit) + "\", \"compiler\": \"" + escapeJson(build.compiler) +
+           "\", \"flags\": \"" + escapeJson(build.flags) + "\", \"cpu\": \"" + escapeJson(build.cpu) + "\"}";
+}
+
+std::string historyFileName(const BuildInfo& build) {
+    // FNV-1a, stable across platforms and standard library versions unlike std::hash
+    uint64_t hash = 14695981039346656037ULL;
+    for (const std::string& part : {build.compiler, build.flags, build.cpu}) {
+        for (const unsigned char c : part + '\n') {
+            hash = (hash ^ c) * 1099511628211ULL;
+        }
+    }
+    char name[96];
+    std::snprintf(name, sizeof(name), "%s-%08x.json", build.commit.c_str(), static_cast<unsigned>(hash >> 32));
+    return name;
+}
+
+std::vector<BenchResult> readBenchJson(const std::string& path, BuildInfo& build) {
+    simdjson::padded_string json;
+    if (simdjson::padded_string::load(path).get(json) != simdjson::SUCCESS) {
+        throw std::runtime_error("Failed to read benchmark results at " + path);
+    }
+    simdjson::ondemand::parser parser;
+    simdjson::ondemand::document document;
+    simdjson::ondemand::object root;
+    if (parser.iterate(json).get(document) != simdjson::SUCCESS ||
+        document.get_object().get(root) != simdjson::SUCCESS) {
+        throw std::runtime_error(path + " isn't a JSON object");
+    }
+
+    std::vector<BenchResult> results;
+    // Members are visited in file order, so the build can be anywhere in the object
+    for (auto field : root) {
+        std::string_view key;
+        if (field.unescaped_key().get(key) != simdjson::SUCCESS) {
+            continue;
+        }
+        if (key == "build") {
+            simdjson::ondemand::object object;
+            if (field.value().get_object().get(object) == simdjson::SUCCESS) {
+                build = {readString_(object, "commit"), readString_(object, "compiler"),
+                         readString_(object, "flags"), readString_(object, "cpu")};
+            }
+        } else if (key == "results") {
+            simdjson::ondemand::array array;
+            if (field.value().get_array().get(array) != simdjson::SUCCESS) {
+                throw std::runtime_error(path + " has no results array");
+            }
+            for (auto element : array) {
+                simdjson::ondemand::object object;
+                if (element.get_object().get(object) != simdjson::SUCCESS) {
+                    continue;
+                }
+                BenchResult result;
+                result.algorithm = readString_(object, "algorithm");
+                result.comparator = readString_(object, "comparator");
+                result.input = readString_(object, "input");
+                uint64_t elements = 0;
+                if (object["elements"].get_uint64().get(elements) == simdjson::SUCCESS) {
+                    result.elements = elements;
+                }
+                bool skipped = false;
+                if (object["skipped"].get_bool().get(skipped) == simdjson::SUCCESS) {
+                    result.skipped = skipped;
+                }
+                simdjson::ondemand::array samples;
+                if (object["samples_ns_per_element"].get_array().get(samples) == simdjson::SUCCESS) {
+                    for (auto sample : samples) {
+                        double value = 0.0;
+                        if (sample.get_double().get(value) == simdjson::SUCCESS) {
+                            result.samples.push_back(value);
+                        }
+                    }
+                }
+                summarizeBenchResult(result);
+                results.push_back(std::move(result));
+            }
+        }
+    }
+    return results;
+}
+
+std::vector<BenchComparison> compareBenchResults(const std::vector<BenchResult>& baseline,
+                                                 const std::vector<BenchResult>& candidate, const double threshold,
+                                                 const double alpha) {
+    std::map<std::string, const BenchResult*> baselineByKey;
+    for (const auto& result : baseline) {
+        if (!result.skipped && !result.samples.empty()) {
+            baselineByKey[benchKey_(result)] = &result;
+        }
+    }
+
+    const double z = normalQuantile_(alpha / 2.0);
+    std::vector<BenchComparison> comparisons;
+    for (const auto& result : candidate) {
+        const auto match = baselineByKey.find(benchKey_(result));
+        if (result.skipped || result.samples.empty() || match == baselineByKey.end()) {
+            continue;
+        }
+        const BenchResult& base = *match->second;
+        BenchComparison comparison;
+        comparison.name = match->first;
+        comparison.baselineMedian = base.median;
+        comparison.candidateMedian = result.median;
+        comparison.baselineTrials = base.samples.size();
+        comparison.candidateTrials = result.samples.size();
+        comparison.pValue = mannWhitneyPValue(result.samples, base.samples);
+
+        // Hodges-Lehmann: the median of every pairwise ratio, with the distribution-free interval
+        // between the order statistics that the U test's critical value points to
+        std::vector<double> ratios;
+        for (const double candidateSample : result.samples) {
+            for (const double baseSample : base.samples) {
+                ratios.push_back(baseSample > 0.0 ? candidateSample / baseSample : 1.0);
+            }
+        }
+        std::ranges::sort(ratios);
+        const auto pairs = static_cast<double>(ratios.size());
+        comparison.ratio = ratios.size() % 2 == 1
+                               ? ratios[ratios.size() / 2]
+                               : (ratios[ratios.size() / 2 - 1] + ratios[ratios.size() / 2]) / 2.0;
+        const double spread = std::sqrt(pairs * static_cast<double>(result.samples.size() + base.samples.size() + 1) /
+                                        12.0);
+        const auto rank = static_cast<size_t>(std::max(0.0, std::floor(pairs / 2.0 - z * spread)));
+        comparison.ratioLow = ratios[std::min(rank, ratios.size() - 1)];
+        comparison.ratioHigh = ratios[ratios.size() - 1 - std::min(rank, ratios.size() - 1)];
+
+        comparisons.push_back(std::move(comparison));
+    }
+
+    // Holm's step-down correction: the k-th smallest of m p-values is scaled by m - k + 1 and kept monotone,
+    // which bounds the chance of any false regression at alpha without Bonferroni's loss of power
+    std::vector<size_t> byPValue(comparisons.size());
+    std::iota(byPValue.begin(), byPValue.end(), 0);
+    std::ranges::stable_sort(byPValue, {}, [&](const size_t index) {
+        return comparisons[index].pValue;
+    });
+    double adjusted = 0.0;
+    for (size_t rank = 0; rank < byPValue.size(); ++rank) {
+        BenchComparison& comparison = comparisons[byPValue[rank]];
+        adjusted = std::max(adjusted, std::min(1.0, comparison.pValue * static_cast<double>(byPValue.size() - rank)));
+        comparison.adjustedPValue = adjusted;
+        comparison.regression = comparison.adjustedPValue < alpha && comparison.ratio > 1.0 + threshold;
+    }
+    return comparisons;
+}
+
+double smallestAdjustedPValue(const std::vector<BenchComparison>& comparisons) {
+    // Most comparisons share their trial counts, so each pair is only tested once
+    std::map<std::pair<size_t, size_t>, double> smallestByTrials;
+    double smallest = 1.0;
+    for (const auto& comparison : comparisons) {
+        const auto [found, added] = smallestByTrials.try_emplace({comparison.candidateTrials,
+                                                                   comparison.baselineTrials});
+        if (added) {
+            std::vector<double> faster(comparison.baselineTrials);
+            std::vector<double> slower(comparison.candidateTrials);
+            std::iota(faster.begin(), faster.end(), 1.0);
+            std::iota(slower.begin(), slower.end(), static_cast<double>(faster.size()) + 1.0);
+            found->second = mannWhitneyPValue(slower, faster);
+        }
+        smallest = std::min(smallest, found->second);
+    }
+    return std::min(1.0, smallest * static_cast<double>(comparisons.size()));
+}
+
+void printBenchComparison(std::ostream& out, const std::vector<BenchComparison>& comparisons, const double alpha) {
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-48s %12s %12s %8s %19s %8s  %s\n", "benchmark", "base ns/el", "new ns/el",
+                  "change", "confidence interval", "adj. p", "verdict");
+    out << line;
+    for (const auto& comparison : comparisons) {
+        const char* verdict = comparison.regression ? "REGRESSION"
+                              : comparison.adjustedPValue >= alpha ? "same"
+                              : comparison.ratio > 1.0 ? "slower"
+                              : "faster";
+        std::snprintf(line, sizeof(line), "%-48s %12.2f %12.2f %+7.1f%% [%+7.1f%%, %+7.1f%%] %8.4f  %s\n",
+                      comparison.name.c_str(), comparison.baselineMedian, comparison.candidateMedian,
+                      (comparison.ratio - 1.0) * 100.0, (comparison.ratioLow - 1.0) * 100.0,
+                      (comparison.ratioHigh - 1.0) * 100.0, comparison.adjustedPValue, verdict);
+        out << line;
+    }
+}
+
+double mannWhitneyPValue(const std::vector<double>& lhs, const std::vector<double>& rhs) {
+    const size_t n = lhs.size();
+    const size_t m = rhs.size();
+    if (n == 0 || m == 0) {
+        return 1.0;
+    }
+
+    // Ranks of the pooled samples, ties get their average rank
+    std::vector<std::pair<double, bool>> pooled;
+    for (const double value : lhs) {
+        pooled.emplace_back(value, true);
+    }
+    for (const double value : rhs) {
+        pooled.emplace_back(value, false);
+    }
+    std::ranges::sort(pooled, {}, &std::pair<double, bool>::first);
+    double lhsRankSum = 0.0;
+    double tieCorrection = 0.0;
+    for (size_t i = 0; i < pooled.size();) {
+        size_t end = i;
+        while (end < pooled.size() && pooled[end].first == pooled[i].first) {
+            ++end;
+        }
+        const double averageRank = static_cast<double>(i + end + 1) / 2.0;
+        for (size_t j = i; j < end; ++j) {
+            if (pooled[j].second) {
+                lhsRankSum += averageRank;
+            }
+        }
+        const auto ties = static_cast<double>(end - i);
+        tieCorrection += ties * ties * ties - ties;
+        i = end;
+    }
+    const double u = lhsRankSum - static_cast<double>(n * (n + 1)) / 2.0;
+    const auto pairs = static_cast<double>(n * m);
+
+    if (tieCorrection == 0.0 && n <= EXACT_LIMIT_ && m <= EXACT_LIMIT_) {
+        const std::vector<double> counts = exactUCounts_(n, m);
+        double total = 0.0;
+        double atMost = 0.0;
+        double atLeast = 0.0;
+        const auto observed = static_cast<size_t>(std::llround(u));
+        for (size_t value = 0; value < counts.size(); ++value) {
+            total += counts[value];
+            atMost += value <= observed ? counts[value] : 0.0;
+            atLeast += value >= observed ? counts[value] : 0.0;
+        }
+        return std::min(1.0, 2.0 * std::min(atMost, atLeast) / total);
+    }
+
+    const auto total = static_cast<double>(n + m);
+    const double variance = pairs / 12.0 * (total + 1.0 - tieCorrection / (total * (total - 1.0)));
+    if (variance <= 0.0) {
+        return 1.0;
+    }
+    const double z = std::max(0.0, std::abs(u - pairs / 2.0) - 0.5) / std::sqrt(variance);
+    return std::min(1.0, 2.0 * normalTail_(z));
+}
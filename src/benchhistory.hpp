@@ -0,0 +1,99 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "benchmark.hpp"
+
+/**
+ * @brief What a benchmark result was measured with
+ *
+ * Results are only comparable between runs of the same compiler, flags and CPU.
+ */
+struct BuildInfo {
+    std::string commit;
+    std::string compiler;
+    std::string flags;
+    std::string cpu;
+};
+
+// The build this program was compiled as, and the CPU it runs on
+BuildInfo currentBuildInfo();
+
+// Write build info as a JSON object
+std::string buildInfoJson(const BuildInfo& build);
+
+/**
+ * @brief File name of a run in a history directory, e.g. "3f2a9c1d04be-7c1e20aa.json"
+ *
+ * The commit, then a hash of the compiler, flags and CPU, so runs of the same
+ * commit on other machines or compilers don't overwrite each other.
+ */
+std::string historyFileName(const BuildInfo& build);
+
+/**
+ * @brief Read the results of a JSON file written by writeBenchJson
+ *
+ * @param path Path to the file
+ * @param build Receives the build the results were measured with, if the file has one
+ * @return The results, with min, median and p95 recomputed from the samples
+ *
+ * Throws std::runtime_error if the file can't be read or isn't a benchmark result.
+ */
+std::vector<BenchResult> readBenchJson(const std::string& path, BuildInfo& build);
+
+// How one benchmark changed between two runs
+struct BenchComparison {
+    std::string name;
+    double baselineMedian = 0.0;
+    double candidateMedian = 0.0;
+    size_t baselineTrials = 0;
+    size_t candidateTrials = 0;
+    // Hodges-Lehmann estimate of candidate / baseline time and its confidence interval, above 1 is slower
+    double ratio = 1.0;
+    double ratioLow = 1.0;
+    double ratioHigh = 1.0;
+    // Two-sided Mann-Whitney U test of the two sets of samples
+    double pValue = 1.0;
+    // pValue after Holm's correction over every benchmark in the comparison
+    double adjustedPValue = 1.0;
+    bool regression = false;
+};
+
+/**
+ * @brief Compare every benchmark that ran in both sets of results
+ *
+ * @param baseline Results to compare against
+ * @param candidate Results to check
+ * @param threshold Slowdown that counts as a regression, e.g. 0.05 for 5 %
+ * @param alpha Family-wise significance level, and 1 - alpha is the confidence of each interval
+ *
+ * A benchmark is a regression if it is significantly slower and its estimated slowdown is
+ * past the threshold. The p-values are Holm-adjusted across all compared benchmarks, so
+ * noise alone fails a run with a chance of at most alpha, however many benchmarks it has.
+ */
+std::vector<BenchComparison> compareBenchResults(const std::vector<BenchResult>& baseline,
+                                                 const std::vector<BenchResult>& candidate, double threshold,
+                                                 double alpha = 0.05);
+
+/**
+ * @brief Smallest Holm-adjusted p-value the comparisons could have reached
+ *
+ * A benchmark's p-value can't go below that of two completely separated sets of samples of
+ * its trial counts, and Holm's correction multiplies the smallest p-value by the number of
+ * benchmarks. If this is at least alpha, no slowdown however large is reported as a
+ * regression and the runs need more trials. 1 if there are no comparisons.
+ */
+double smallestAdjustedPValue(const std::vector<BenchComparison>& comparisons);
+
+// Print comparisons as an aligned text table
+void printBenchComparison(std::ostream& out, const std::vector<BenchComparison>& comparisons, double alpha = 0.05);
+
+/**
+ * @brief Two-sided p-value of the Mann-Whitney U test
+ *
+ * Exact for small samples without ties, otherwise the normal approximation
+ * with tie and continuity corrections.
+ */
+double mannWhitneyPValue(const std::vector<double>& lhs, const std::vector<double>& rhs);
@@ -0,0 +1,204 @@
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+#include "allocprofile.hpp"
+#include "trace.hpp"
+
+namespace {
+    // Nearest-rank percentile of sorted samples
+    double percentile_(const std::vector<double>& sorted, const double fraction) {
+        if (sorted.empty()) {
+            return 0.0;
+        }
+        const auto rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+        return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+    }
+
+    // Sort a fresh copy of the input for every warmup and trial, and record the trials' times and events
+    template<typename Sort>
+    void timeTrials_(BenchResult& result, const std::vector<Game*>& input, const BenchOptions& options,
+                     const Sort& sort) {
+        using clock = std::chrono::steady_clock;
+        std::vector<Game*> games;
+        for (size_t run = 0; run < options.warmups + options.trials; ++run) {
+            games = input;
+            const trace::Span trialSpan(run < options.warmups ? "warmup" : "trial");
+            const perf::CounterValues eventsStart = perf::readCounters();
+            const auto timeStart = clock::now();
+            sort(games);
+            const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - timeStart);
+            const perf::CounterValues events = perf::readCounters() - eventsStart;
+            if (run >= options.warmups) {
+                result.samples.push_back(static_cast<double>(elapsed.count()) / static_cast<double>(input.size()));
+                result.events += events;
+            }
+        }
+        summarizeBenchResult(result);
+    }
+
+    // Events of one event kind per element and trial
+    double perElement_(const BenchResult& result, const perf::Event event) {
+        return static_cast<double>(result.events[event]) /
+               static_cast<double>(result.elements * std::max<size_t>(result.samples.size(), 1));
+    }
+}
+
+BenchResult runSortBenchmark(const SortAlgorithm& algorithm, const SortComparator& comparator,
+                             const std::vector<Game*>& input, const std::string& inputName,
+                             const BenchOptions& options) {
+    BenchResult result;
+    result.algorithm = algorithm.name;
+    result.comparator = comparator.name;
+    result.input = inputName;
+    result.elements = input.size();
+    if (input.empty() || (algorithm.quadratic && input.size() > options.quadraticLimit)) {
+        result.skipped = true;
+        return result;
+    }
+
+    const trace::Span span("benchmark", std::string(algorithm.name) + ' ' + comparator.name + ' ' + inputName);
+    timeTrials_(result, input, options, [&](std::vector<Game*>& games) {
+        algorithm.sort(games, comparator.compare);
+    });
+
+    if constexpr (instr::ENABLED) {
+        std::vector<Game*> games = input;
+        const heap::Phase phase(std::string("sort ") + algorithm.name);
+        instr::beginCounting();
+        algorithm.sort(games, instr::countComparisons(comparator.compare));
+        result.counters = instr::endCounting();
+    }
+    return result;
+}
+
+BenchResult runCustomSortBenchmark(const std::string& algorithm, const std::string& comparator,
+                                   const std::vector<Game*>& input, const std::string& inputName,
+                                   const BenchOptions& options, const std::function<void(std::vector<Game*>&)>& sort) {
+    BenchResult result;
+    result.algorithm = algorithm;
+    result.comparator = comparator;
+    result.input = inputName;
+    result.elements = input.size();
+    if (input.empty()) {
+        result.skipped = true;
+        return result;
+    }
+    const trace::Span span("benchmark", algorithm + ' ' + comparator + ' ' + inputName);
+    timeTrials_(result, input, options, sort);
+    return result;
+}
+
+void summarizeBenchResult(BenchResult& result) {
+    std::vector<double> sorted = result.samples;
+    std::ranges::sort(sorted.begin(), sorted.end());
+    result.min = sorted.empty() ? 0.0 : sorted.front();
+    result.median = percentile_(sorted, 0.5);
+    result.p95 = percentile_(sorted, 0.95);
+}
+
+void printBenchTable(std::ostream& out, const std::vector<BenchResult>& results) {
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-22s %-9s %-12s %10s %12s %12s %12s", "algorithm", "field", "input",
+                  "elements", "min ns/el", "median ns/el", "p95 ns/el");
+    out << line;
+    if constexpr (instr::ENABLED) {
+        // Comparisons relative to the n*log2(n) bound of a comparison sort, moves and allocations per run
+        std::snprintf(line, sizeof(line), " %10s %9s %9s", "cmp/nlgn", "moves/el", "allocs");
+        out << line;
+    }
+    const bool hasEvents = std::ranges::any_of(results, [](const BenchResult& result) {
+        return result.events.available != 0;
+    });
+    if (hasEvents) {
+        // Misses per element of each trial, IPC shows whether the sort waits on memory
+        std::snprintf(line, sizeof(line), " %6s %8s %8s %8s %8s", "ipc", "l1d/el", "llc/el", "br/el", "dtlb/el");
+        out << line;
+    }
+    out << '\n';
+    for (const auto& result : results) {
+        if (result.skipped) {
+            std::snprintf(line, sizeof(line), "%-22s %-9s %-12s %10zu %12s\n", result.algorithm.c_str(),
+                          result.comparator.c_str(), result.input.c_str(), result.elements, "skipped");
+            out << line;
+            continue;
+        }
+        std::snprintf(line, sizeof(line), "%-22s %-9s %-12s %10zu %12.2f %12.2f %12.2f", result.algorithm.c_str(),
+                      result.comparator.c_str(), result.input.c_str(), result.elements, result.min, result.median,
+                      result.p95);
+        out << line;
+        if constexpr (instr::ENABLED) {
+            const auto elements = static_cast<double>(result.elements);
+            const double bound = elements * std::max(std::log2(elements), 1.0);
+            std::snprintf(line, sizeof(line), " %10.3f %9.2f %9llu",
+                          static_cast<double>(result.counters.comparisons) / bound,
+                          static_cast<double>(result.counters.moves) / elements,
+                          static_cast<unsigned long long>(result.counters.allocations));
+            out << line;
+        }
+        if (hasEvents) {
+            std::snprintf(line, sizeof(line), " %6.2f %8.3f %8.3f %8.3f %8.3f", result.events.ipc(),
+                          perElement_(result, perf::Event::L1dMisses), perElement_(result, perf::Event::LlcMisses),
+                          perElement_(result, perf::Event::BranchMisses),
+                          perElement_(result, perf::Event::DtlbMisses));
+            out << line;
+        }
+        out << '\n';
+    }
+}
+
+void writeBenchJson(std::ostream& out, const std::vector<BenchResult>& results, const std::string& metadataJson) {
+    out << "{\n";
+    if (!metadataJson.empty()) {
+        out << "  " << metadataJson << ",\n";
+    }
+    out << "  \"results\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& result = results[i];
+        out << (i == 0 ? "\n" : ",\n") << "    {\"algorithm\": \"" << escapeJson(result.algorithm)
+            << "\", \"comparator\": \"" << escapeJson(result.comparator) << "\", \"input\": \""
+            << escapeJson(result.input) << "\", \"elements\": " << result.elements
+            << ", \"skipped\": " << (result.skipped ? "true" : "false");
+        if (!result.skipped) {
+            out << ", \"min_ns_per_element\": " << result.min << ", \"median_ns_per_element\": " << result.median
+                << ", \"p95_ns_per_element\": " << result.p95 << ", \"samples_ns_per_element\": [";
+            for (size_t sample = 0; sample < result.samples.size(); ++sample) {
+                out << (sample == 0 ? "" : ", ") << result.samples[sample];
+            }
+            out << ']';
+            if constexpr (instr::ENABLED) {
+                out << ", \"comparisons\": " << result.counters.comparisons << ", \"moves\": "
+                    << result.counters.moves << ", \"allocations\": " << result.counters.allocations
+                    << ", \"allocated_bytes\": " << result.counters.allocatedBytes;
+            }
+            if (result.events.available != 0) {
+                out << ", \"ipc\": " << result.events.ipc() << ", \"events_per_element\": "
+                    << perf::countersJson(result.events,
+                                          static_cast<double>(result.elements * result.samples.size()));
+            }
+        }
+        out << '}';
+    }
+    out << "\n  ]\n}\n";
+}
+
+std::string escapeJson(const std::string& text) {
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (const unsigned char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += static_cast<char>(c);
+        } else if (c < 0x20) {
+            char code[8];
+            std::snprintf(code, sizeof(code), "\\u%04x", c);
+            escaped += code;
+        } else {
+            escaped += static_cast<char>(c);
+        }
+    }
+    return escaped;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Game.hpp"
+#include "instrument.hpp"
+#include "perfcounters.hpp"
+#include "sorts.hpp"
+
+struct BenchOptions {
+    size_t warmups = 1;
+    // Enough for --compare to find a regression among a few hundred benchmarks, see smallestAdjustedPValue()
+    size_t trials = 15;
+    // Skip O(n^2) algorithms above this many elements, they would take minutes per trial
+    size_t quadraticLimit = 50'000;
+};
+
+/**
+ * @brief Timings of one algorithm and comparator on one input
+ *
+ * samples holds the nanoseconds per element of every trial in the order
+ * they ran. skipped is set instead when the algorithm wasn't run.
+ * counters is only filled in by instrumented builds, see instrument.hpp.
+ * events sums the hardware counters of the timed trials, see perfcounters.hpp.
+ */
+struct BenchResult {
+    std::string algorithm;
+    std::string comparator;
+    std::string input;
+    size_t elements = 0;
+    bool skipped = false;
+    std::vector<double> samples;
+    double min = 0.0;
+    double median = 0.0;
+    double p95 = 0.0;
+    instr::SortCounters counters;
+    perf::CounterValues events;
+};
+
+/**
+ * @brief Time one algorithm with one comparator
+ *
+ * @param algorithm Sort to run
+ * @param comparator Ordering to sort by
+ * @param input Games in the order every trial starts from, never modified
+ * @param inputName Name of the input order, reported with the result
+ * @param options Number of warmup and timed trials
+ *
+ * Every warmup and trial sorts a fresh copy of the input. Copying isn't timed
+ * or counted.
+ * Instrumented builds add one more untimed run that counts comparisons, moves
+ * and allocations, so the counting overhead never ends up in the samples. Its
+ * allocations are also profiled as the phase "sort <algorithm>", see allocprofile.hpp.
+ */
+BenchResult runSortBenchmark(const SortAlgorithm& algorithm, const SortComparator& comparator,
+                             const std::vector<Game*>& input, const std::string& inputName,
+                             const BenchOptions& options);
+
+/**
+ * @brief Time a sort that isn't a SortAlgorithm, such as compositeSort
+ *
+ * Times trials the same way as runSortBenchmark. Instrumented builds don't count anything,
+ * the sort can't be handed a counting comparator.
+ *
+ * @param sort Sorts the games it is given in place
+ */
+BenchResult runCustomSortBenchmark(const std::string& algorithm, const std::string& comparator,
+                                   const std::vector<Game*>& input, const std::string& inputName,
+                                   const BenchOptions& options, const std::function<void(std::vector<Game*>&)>& sort);
+
+// Fill in min, median and p95 from the samples
+void summarizeBenchResult(BenchResult& result);
+
+// Print results as an aligned text table
+void printBenchTable(std::ostream& out, const std::vector<BenchResult>& results);
+
+/**
+ * @brief Write results as a JSON object
+ *
+ * @param out Stream to write to
+ * @param results Results to write, raw samples included
+ * @param metadataJson Members of the top-level object written before the results,
+ * e.g. "\"dataset\": \"real\"", without a trailing comma. Can be empty.
+ */
+void writeBenchJson(std::ostream& out, const std::vector<BenchResult>& results, const std::string& metadataJson);
+
+// Escape a string for use inside a JSON string literal
+std::string escapeJson(const std::string& text);
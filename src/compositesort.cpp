@@ -0,0 +1,234 @@
+#include "compositesort.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+#include "trace.hpp"
+
+namespace {
+    // Buckets this small are sorted by comparing keys, the counting passes cost more than they save
+    constexpr size_t RADIX_CUTOFF_ = 64;
+
+    constexpr std::array<std::pair<std::string_view, SortField>, 6> FIELD_NAMES_ = {{
+        {"title", SortField::Title},
+        {"rating", SortField::Rating},
+        {"genre", SortField::Genre},
+        {"platform", SortField::Platform},
+        {"year", SortField::Year},
+        {"id", SortField::Id},
+    }};
+
+    void appendBigEndian_(const uint64_t value, const int bytes, std::string& out) {
+        for (int shift = (bytes - 1) * 8; shift >= 0; shift -= 8) {
+            out += static_cast<char>(value >> shift & 0xFF);
+        }
+    }
+
+    // 0x00 can be in the text, so it is escaped and the end is two bytes below any escaped byte
+    void appendString_(const std::string_view text, const bool lowercase, std::string& out) {
+        for (const char c : text) {
+            if (c == '\0') {
+                out += '\0';
+                out += '\xFF';
+            } else {
+                out += lowercase && c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+            }
+        }
+        out += '\0';
+        out += '\0';
+    }
+
+    // IEEE 754 doubles order like their bits once negatives are inverted and positives get the sign bit
+    void appendDouble_(double value, std::string& out) {
+        if (value == 0.0) {
+            // -0.0 equals 0.0
+            value = 0.0;
+        }
+        const auto bits = std::bit_cast<uint64_t>(value);
+        appendBigEndian_((bits >> 63) != 0 ? ~bits : bits | 1ULL << 63, 8, out);
+    }
+
+    std::weak_ordering orderField_(const SortField field, const Game* lhs, const Game* rhs) {
+        switch (field) {
+            case SortField::Title:
+                return Game::orderTitles(lhs, rhs);
+            case SortField::Rating:
+                return std::weak_order(lhs->get_score() == 0.0 ? 0.0 : lhs->get_score(),
+                                       rhs->get_score() == 0.0 ? 0.0 : rhs->get_score());
+            case SortField::Genre:
+                return Game::orderGenres(lhs, rhs);
+            case SortField::Platform:
+                return Game::orderPlatforms(lhs, rhs);
+            case SortField::Year:
+                return lhs->get_release_year() <=> rhs->get_release_year();
+            case SortField::Id:
+                return lhs->get_id() <=> rhs->get_id();
+        }
+        return std::weak_ordering::equivalent;
+    }
+
+    // Stable MSD radix sort of the indices by their keys, all of which agree on the first depth bytes
+    void radixSort_(const PackedKeys& keys, uint32_t* first, uint32_t* last, uint32_t* buffer, size_t depth) {
+        while (static_cast<size_t>(last - first) >= RADIX_CUTOFF_) {
+            // Bucket 0 holds the keys that end at depth, bucket b + 1 those with byte b there
+            std::array<size_t, 258> starts{};
+            for (const uint32_t* index = first; index != last; ++index) {
+                const std::string_view key = keys[*index];
+                ++starts[key.size() > depth ? static_cast<unsigned char>(key[depth]) + 2U : 1U];
+            }
+            const auto count = static_cast<size_t>(last - first);
+            if (std::ranges::find(starts, count) != starts.end() && starts[1] != count) {
+                // One byte value for every key, nothing to distribute
+                ++depth;
+                continue;
+            }
+            std::partial_sum(starts.begin(), starts.end(), starts.begin());
+            std::array<size_t, 258> positions = starts;
+            for (const uint32_t* index = first; index != last; ++index) {
+                const std::string_view key = keys[*index];
+                buffer[positions[key.size() > depth ? static_cast<unsigned char>(key[depth]) + 1U : 0U]++] = *index;
+            }
+            std::copy(buffer, buffer + count, first);
+            // The keys that ended are all equal, every other bucket continues with the next byte
+            for (size_t bucket = 1; bucket + 1 < starts.size(); ++bucket) {
+                if (starts[bucket + 1] - starts[bucket] > 1) {
+                    radixSort_(keys, first + starts[bucket], first + starts[bucket + 1], buffer, depth + 1);
+                }
+            }
+            return;
+        }
+        std::stable_sort(first, last, [&](const uint32_t lhs, const uint32_t rhs) {
+            return keys[lhs].substr(depth) < keys[rhs].substr(depth);
+        });
+    }
+}
+
+std::vector<SortKey> parseSortKeys(const std::string_view text) {
+    std::vector<SortKey> keys;
+    size_t start = 0;
+    while (start <= text.size()) {
+        const size_t end = std::min(text.find(',', start), text.size());
+        std::string_view name = text.substr(start, end - start);
+        SortKey key{SortField::Title, false};
+        if (name.starts_with('-') || name.starts_with('+')) {
+            key.descending = name.front() == '-';
+            name.remove_prefix(1);
+        }
+        const auto field = std::ranges::find(FIELD_NAMES_, name, &std::pair<std::string_view, SortField>::first);
+        if (field == FIELD_NAMES_.end()) {
+            throw std::invalid_argument("Unknown sort field \"" + std::string(name) +
+                                        "\", expected title, rating, genre, platform, year or id");
+        }
+        key.field = field->second;
+        keys.push_back(key);
+        start = end + 1;
+    }
+    return keys;
+}
+
+std::string sortKeysName(const std::vector<SortKey>& keys) {
+    std::string name;
+    for (const auto& key : keys) {
+        if (!name.empty()) {
+            name += ',';
+        }
+        if (key.descending) {
+            name += '-';
+        }
+        name += std::ranges::find(FIELD_NAMES_, key.field, &std::pair<std::string_view, SortField>::second)->first;
+    }
+    return name;
+}
+
+bool compositeLess(const std::vector<SortKey>& keys, const Game* const lhs, const Game* const rhs) {
+    for (const auto& key : keys) {
+        const std::weak_ordering order = orderField_(key.field, lhs, rhs);
+        if (order != 0) {
+            return key.descending ? order > 0 : order < 0;
+        }
+    }
+    return false;
+}
+
+PackedKeys::PackedKeys(const std::vector<Game*>& games, const std::vector<SortKey>& keys) {
+    starts_.reserve(games.size() + 1);
+    for (const Game* game : games) {
+        starts_.push_back(bytes_.size());
+        appendKey(*game, keys, bytes_);
+    }
+    starts_.push_back(bytes_.size());
+}
+
+size_t PackedKeys::size() const {
+    return starts_.size() - 1;
+}
+
+std::string_view PackedKeys::operator[](const size_t index) const {
+    return std::string_view(bytes_).substr(starts_[index], starts_[index + 1] - starts_[index]);
+}
+
+size_t PackedKeys::getBytes() const {
+    return bytes_.size();
+}
+
+void PackedKeys::appendKey(const Game& game, const std::vector<SortKey>& keys, std::string& out) {
+    for (const auto& key : keys) {
+        const size_t start = out.size();
+        switch (key.field) {
+            case SortField::Title:
+                appendString_(game.get_title(), false, out);
+                break;
+            case SortField::Rating:
+                appendDouble_(game.get_score(), out);
+                break;
+            case SortField::Genre:
+                for (const auto& genre : game.get_genres()) {
+                    out += '\x01';
+                    appendString_(genre, false, out);
+                }
+                out += '\0';
+                break;
+            case SortField::Platform:
+                appendString_(game.get_platform(), true, out);
+                break;
+            case SortField::Year:
+                appendBigEndian_(static_cast<uint32_t>(game.get_release_year()) ^ 0x80000000U, 4, out);
+                break;
+            case SortField::Id:
+                appendBigEndian_(game.get_id(), 8, out);
+                break;
+        }
+        if (key.descending) {
+            std::for_each(out.begin() + static_cast<std::ptrdiff_t>(start), out.end(), [](char& c) {
+                c = static_cast<char>(~c);
+            });
+        }
+    }
+}
+
+void compositeSort(std::vector<Game*>& games, const std::vector<SortKey>& keys) {
+    if (games.size() > std::numeric_limits<uint32_t>::max()) {
+        throw std::invalid_argument("compositeSort sorts at most 2^32 games");
+    }
+    const trace::Span span("composite sort", sortKeysName(keys));
+    const PackedKeys packed = [&] {
+        const trace::Span packSpan("pack keys");
+        return PackedKeys(games, keys);
+    }();
+    std::vector<uint32_t> order(games.size());
+    std::iota(order.begin(), order.end(), 0U);
+    std::vector<uint32_t> buffer(games.size());
+    radixSort_(packed, order.data(), order.data() + order.size(), buffer.data(), 0);
+
+    std::vector<Game*> sorted;
+    sorted.reserve(games.size());
+    for (const uint32_t index : order) {
+        sorted.push_back(games[index]);
+    }
+    games = std::move(sorted);
+}
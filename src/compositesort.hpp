@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Game.hpp"
+
+// Fields an order on several fields can use, see parseSortKeys()
+enum class SortField {
+    Title,
+    Rating,
+    Genre,
+    Platform,
+    Year,
+    Id
+};
+
+// One field of a composite order, the first key decides and later ones break its ties
+struct SortKey {
+    SortField field;
+    bool descending = false;
+};
+
+/**
+ * @brief Parse an order such as "platform,-rating,title"
+ *
+ * Fields are title, rating, genre, platform, year and id, separated by commas. A leading
+ * "-" sorts that field in descending order and a leading "+" or nothing in ascending
+ * order. Rating ascends from the lowest score, unlike the rating button. Throws
+ * std::invalid_argument for an unknown or missing field.
+ */
+std::vector<SortKey> parseSortKeys(std::string_view text);
+
+// The order back in the form parseSortKeys() reads
+std::string sortKeysName(const std::vector<SortKey>& keys);
+
+// True if lhs goes before rhs, comparing one field after another through Game's order functions
+bool compositeLess(const std::vector<SortKey>& keys, const Game* lhs, const Game* rhs);
+
+/**
+ * @brief Every game's fields encoded into one byte string that compares like the order
+ *
+ * Each field is encoded so that comparing the bytes with memcmp orders like the field:
+ * numbers big-endian with the sign bit flipped (all bits for negative doubles), strings
+ * with 0x00 escaped to 0x00 0xFF and terminated by 0x00 0x00, genre lists as 0x01 before
+ * every genre and 0x00 after the last. A descending field has its bytes inverted. The
+ * encodings are prefix-free, so the keys of two games compare like compositeLess on them,
+ * with shorter keys first where one is a prefix of the other.
+ */
+class PackedKeys {
+public:
+    PackedKeys(const std::vector<Game*>& games, const std::vector<SortKey>& keys);
+
+    [[nodiscard("Getter")]] size_t size() const;
+
+    [[nodiscard("Getter")]] std::string_view operator[](size_t index) const;
+
+    // Bytes of every key together
+    [[nodiscard("Getter")]] size_t getBytes() const;
+
+    static void appendKey(const Game& game, const std::vector<SortKey>& keys, std::string& out);
+
+private:
+    std::string bytes_;
+    // Key i is bytes_[starts_[i], starts_[i + 1])
+    std::vector<size_t> starts_;
+};
+
+/**
+ * @brief Stable sort by a composite order
+ *
+ * Packs a key per game, then sorts the games by their keys with an MSD radix sort that
+ * distributes by one key byte per pass and falls back to comparing whole keys in small
+ * buckets. Every comparison is a memcmp of two keys, never a call through a comparator.
+ * Gives the same result as std::stable_sort with compositeLess.
+ */
+void compositeSort(std::vector<Game*>& games, const std::vector<SortKey>& keys);
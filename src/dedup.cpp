@@ -0,0 +1,152 @@
+#include "dedup.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+    // Identity of a game: its platform plus its id, or its normalized title if it has no id
+    struct DedupKey_ {
+        uint64_t id = 0;
+        size_t platform = 0;
+        std::string title;
+
+        bool operator==(const DedupKey_& rhs) const = default;
+    };
+
+    struct DedupKeyHash_ {
+        size_t operator()(const DedupKey_& key) const {
+            // Mix with the 64-bit golden ratio so that ids, platforms and titles don't cancel each other out
+            size_t hash = std::hash<std::string>{}(key.title);
+            hash ^= (key.id + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2));
+            hash ^= (key.platform + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2));
+            return hash;
+        }
+    };
+
+    // Numbers normalized platform names. Games of one platform are loaded together, so the last lookup is cached
+    class PlatformIds_ {
+    public:
+        size_t get(const std::string& platform) {
+            if (platform != lastPlatform_ || ids_.empty()) {
+                lastPlatform_ = platform;
+                lastId_ = ids_.try_emplace(normalizeKey(platform), ids_.size()).first->second;
+            }
+            return lastId_;
+        }
+
+        // Alphabetical rank of every platform id
+        [[nodiscard]] std::vector<size_t> ranks() const {
+            std::vector<std::pair<std::string_view, size_t>> byName(ids_.begin(), ids_.end());
+            std::ranges::sort(byName);
+            std::vector<size_t> ranks(ids_.size());
+            for (size_t rank = 0; rank < byName.size(); ++rank) {
+                ranks[byName[rank].second] = rank;
+            }
+            return ranks;
+        }
+
+    private:
+        std::unordered_map<std::string, size_t> ids_;
+        std::string lastPlatform_;
+        size_t lastId_ = 0;
+    };
+}
+
+size_t GameGroups::size() const {
+    return offsets.empty() ? 0 : offsets.size() - 1;
+}
+
+std::span<Game* const> GameGroups::group(const size_t index) const {
+    return {members.data() + offsets[index], offsets[index + 1] - offsets[index]};
+}
+
+std::string normalizeKey(const std::string& text) {
+    std::string normalized;
+    normalized.reserve(text.size());
+    bool pendingSpace = false;
+    for (const unsigned char c : text) {
+        if (std::isspace(c)) {
+            pendingSpace = !normalized.empty();
+            continue;
+        }
+        if (pendingSpace) {
+            normalized += ' ';
+            pendingSpace = false;
+        }
+        normalized += static_cast<char>(std::tolower(c));
+    }
+    return normalized;
+}
+
+size_t dedupGames(std::vector<Game*>& games, GameGroups* groups) {
+    // Pass 1: drop every game whose key was already seen, keeping the order of the rest
+    std::unordered_set<DedupKey_, DedupKeyHash_> seen;
+    seen.reserve(games.size());
+    PlatformIds_ platformIds;
+    std::vector<size_t> platformOfGame(games.size());
+    size_t kept = 0;
+    for (Game* game : games) {
+        DedupKey_ key{game->get_id(), platformIds.get(game->get_platform()), {}};
+        if (key.id == 0) {
+            key.title = normalizeKey(game->get_title());
+        }
+        const size_t platform = key.platform;
+        if (seen.insert(std::move(key)).second) {
+            platformOfGame[kept] = platform;
+            games[kept++] = game;
+        } else {
+            delete game;
+        }
+    }
+    const size_t duplicates = games.size() - kept;
+    games.resize(kept);
+
+    if (!groups) {
+        return duplicates;
+    }
+
+    // Pass 2: assign every game a group, by id or by normalized title for games without one
+    std::unordered_map<uint64_t, size_t> idGroups;
+    std::unordered_map<std::string, size_t> titleGroups;
+    idGroups.reserve(games.size());
+    std::vector<size_t> groupOfGame(games.size());
+    std::vector<size_t> groupSizes;
+    for (size_t i = 0; i < games.size(); ++i) {
+        const size_t nextGroup = groupSizes.size();
+        const size_t group = games[i]->get_id() != 0
+                                 ? idGroups.try_emplace(games[i]->get_id(), nextGroup).first->second
+                                 : titleGroups.try_emplace(normalizeKey(games[i]->get_title()), nextGroup).first->second;
+        if (group == nextGroup) {
+            groupSizes.push_back(0);
+        }
+        ++groupSizes[group];
+        groupOfGame[i] = group;
+    }
+
+    // Counting sort the games into one flat member array
+    groups->offsets.assign(groupSizes.size() + 1, 0);
+    for (size_t group = 0; group < groupSizes.size(); ++group) {
+        groups->offsets[group + 1] = groups->offsets[group] + groupSizes[group];
+    }
+    std::vector<size_t> cursor(groups->offsets.begin(), groups->offsets.end() - 1);
+    // Order each group by platform name. Platforms are unique within a group after pass 1, so ranks never tie
+    const std::vector<size_t> platformRanks = platformIds.ranks();
+    std::vector<size_t> memberIndices(games.size());
+    for (size_t i = 0; i < games.size(); ++i) {
+        memberIndices[cursor[groupOfGame[i]]++] = i;
+    }
+    for (size_t group = 0; group < groupSizes.size(); ++group) {
+        std::sort(memberIndices.begin() + static_cast<long long>(groups->offsets[group]),
+                  memberIndices.begin() + static_cast<long long>(groups->offsets[group + 1]),
+                  [&](const size_t lhs, const size_t rhs) {
+                      return platformRanks[platformOfGame[lhs]] < platformRanks[platformOfGame[rhs]];
+                  });
+    }
+    groups->members.resize(games.size());
+    for (size_t i = 0; i < games.size(); ++i) {
+        groups->members[i] = games[memberIndices[i]];
+    }
+    return duplicates;
+}
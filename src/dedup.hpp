@@ -0,0 +1,47 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Game.hpp"
+
+/**
+ * @brief Compact table of the same game released on several platforms
+ *
+ * Games are grouped by their MobyGames id, or by their normalized title
+ * when they have no id. Group g consists of
+ * members[offsets[g]] .. members[offsets[g + 1] - 1], ordered by platform,
+ * and groups are ordered by their first appearance in the games vector.
+ */
+struct GameGroups {
+    std::vector<size_t> offsets;
+    std::vector<Game*> members;
+
+    [[nodiscard]] size_t size() const;
+
+    [[nodiscard]] std::span<Game* const> group(size_t index) const;
+};
+
+/**
+ * @brief Lowercase a string, trim it and collapse runs of whitespace into one space
+ *
+ * @param text The string to normalize
+ */
+std::string normalizeKey(const std::string& text);
+
+/**
+ * @brief Remove duplicate games and group the remaining ones across platforms
+ *
+ * @param games Loaded games, duplicates are erased from it and deleted
+ * @param groups If not null, receives the cross-platform group table
+ * @return The number of duplicates removed
+ *
+ * Two games are duplicates if they share a platform and their MobyGames id,
+ * or, for games without an id, their normalized title. Different games
+ * that happen to share a title on one platform are kept. The first occurrence
+ * of a duplicate is kept and the relative order of the games is preserved.
+ *
+ * Both passes are single hash lookups per game, O(n) expected time.
+ */
+size_t dedupGames(std::vector<Game*>& games, GameGroups* groups = nullptr);
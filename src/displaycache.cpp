@@ -0,0 +1,168 @@
+#include "displaycache.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+namespace {
+    constexpr size_t MAX_TITLE_LENGTH_ = 100;
+    constexpr size_t MAX_FIELD_LENGTH_ = 20;
+    constexpr size_t MAX_GENRES_ = 5;
+    // The first line of a title is one character longer than the rest
+    constexpr size_t FIRST_TITLE_LINE_ = 24;
+    constexpr size_t TITLE_LINE_ = 23;
+
+    // Cut off at maxLength with the last three characters replaced by an ellipsis
+    void appendTruncated_(const std::string_view text, const size_t maxLength, std::string& out) {
+        if (text.size() <= maxLength) {
+            out += text;
+            return;
+        }
+        out += text.substr(0, maxLength - 3);
+        out += "...";
+    }
+}
+
+DisplayCache::DisplayCache(const size_t capacity) : capacity_(capacity) {
+    if (capacity == 0 || capacity >= NONE_) {
+        throw std::invalid_argument("The display cache needs room for at least one game");
+    }
+}
+
+DisplayCache::Strings DisplayCache::get(const Game& game) {
+    const auto cached = index_.find(&game);
+    if (cached != index_.end()) {
+        unlink_(cached->second);
+        pushNewest_(cached->second);
+        return strings_(entries_[cached->second]);
+    }
+
+    uint32_t slot = 0;
+    if (entries_.size() < capacity_) {
+        slot = static_cast<uint32_t>(entries_.size());
+        entries_.emplace_back();
+    } else {
+        slot = oldest_;
+        unlink_(slot);
+        index_.erase(entries_[slot].game);
+        deadBytes_ += entries_[slot].length();
+    }
+    if (deadBytes_ > pool_.size() / 2) {
+        compact_();
+    }
+
+    Entry_& entry = entries_[slot];
+    entry.game = &game;
+    entry.offset = static_cast<uint32_t>(pool_.size());
+    // Every field is bounded, see the format functions, so the lengths fit
+    scratch_.clear();
+    formatTitle(game.get_title(), scratch_);
+    entry.titleLength = static_cast<uint16_t>(scratch_.size());
+    formatRating(game.get_score(), scratch_);
+    entry.ratingLength = static_cast<uint16_t>(scratch_.size() - entry.titleLength);
+    formatPlatform(game.get_platform(), scratch_);
+    entry.platformLength = static_cast<uint16_t>(scratch_.size() - entry.titleLength - entry.ratingLength);
+    formatGenres(game.get_genres(), scratch_);
+    entry.genresLength = static_cast<uint16_t>(scratch_.size() - entry.titleLength - entry.ratingLength -
+                                               entry.platformLength);
+    pool_ += scratch_;
+
+    index_.emplace(&game, slot);
+    pushNewest_(slot);
+    return strings_(entry);
+}
+
+void DisplayCache::clear() {
+    entries_.clear();
+    index_.clear();
+    pool_.clear();
+    deadBytes_ = 0;
+    newest_ = NONE_;
+    oldest_ = NONE_;
+}
+
+size_t DisplayCache::size() const {
+    return index_.size();
+}
+
+size_t DisplayCache::capacity() const {
+    return capacity_;
+}
+
+size_t DisplayCache::getPoolBytes() const {
+    return pool_.size();
+}
+
+void DisplayCache::formatTitle(std::string_view title, std::string& out) {
+    std::string truncated;
+    if (title.size() >= MAX_TITLE_LENGTH_) {
+        truncated = std::string(title.substr(0, MAX_TITLE_LENGTH_ - 3)) + "...";
+        title = truncated;
+    }
+    // Each line is appended once instead of inserting every break into the finished title
+    size_t lineLength = FIRST_TITLE_LINE_;
+    for (size_t position = 0; position < title.size();) {
+        if (position > 0) {
+            out += "-\n";
+        }
+        out += title.substr(position, lineLength);
+        position += lineLength;
+        lineLength = TITLE_LINE_;
+    }
+}
+
+void DisplayCache::formatRating(const double score, std::string& out) {
+    char rating[32];
+    const int length = std::snprintf(rating, sizeof(rating), "%.2f / 10", score);
+    out.append(rating, static_cast<size_t>(std::clamp(length, 0, static_cast<int>(sizeof(rating)) - 1)));
+}
+
+void DisplayCache::formatPlatform(const std::string_view platform, std::string& out) {
+    appendTruncated_(platform, MAX_FIELD_LENGTH_, out);
+}
+
+void DisplayCache::formatGenres(const std::vector<std::string>& genres, std::string& out) {
+    for (size_t genreIndex = 0; genreIndex < genres.size() && genreIndex < MAX_GENRES_; ++genreIndex) {
+        appendTruncated_(genres[genreIndex], MAX_FIELD_LENGTH_, out);
+        out += '\n';
+    }
+}
+
+uint32_t DisplayCache::Entry_::length() const {
+    return static_cast<uint32_t>(titleLength) + ratingLength + platformLength + genresLength;
+}
+
+void DisplayCache::unlink_(const uint32_t entry) {
+    Entry_& unlinked = entries_[entry];
+    (unlinked.newer == NONE_ ? newest_ : entries_[unlinked.newer].older) = unlinked.older;
+    (unlinked.older == NONE_ ? oldest_ : entries_[unlinked.older].newer) = unlinked.newer;
+    unlinked.newer = NONE_;
+    unlinked.older = NONE_;
+}
+
+void DisplayCache::pushNewest_(const uint32_t entry) {
+    entries_[entry].older = newest_;
+    entries_[entry].newer = NONE_;
+    (newest_ == NONE_ ? oldest_ : entries_[newest_].newer) = entry;
+    newest_ = entry;
+}
+
+void DisplayCache::compact_() {
+    std::string pool;
+    pool.reserve(pool_.size() - deadBytes_);
+    for (const auto& [game, slot] : index_) {
+        Entry_& entry = entries_[slot];
+        const auto offset = static_cast<uint32_t>(pool.size());
+        pool.append(pool_, entry.offset, entry.length());
+        entry.offset = offset;
+    }
+    pool_ = std::move(pool);
+    deadBytes_ = 0;
+}
+
+DisplayCache::Strings DisplayCache::strings_(const Entry_& entry) const {
+    const std::string_view strings(pool_.data() + entry.offset, entry.length());
+    return {strings.substr(0, entry.titleLength), strings.substr(entry.titleLength, entry.ratingLength),
+            strings.substr(entry.titleLength + entry.ratingLength, entry.platformLength),
+            strings.substr(entry.titleLength + entry.ratingLength + entry.platformLength)};
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Game.hpp"
+
+/**
+ * @brief The strings the main window shows for a game, formatted on first display
+ *
+ * Holds the wrapped title, the score label, the platform and the genre block of the games
+ * shown most recently, up to a fixed number of games, and forgets the least recently shown
+ * one when a new game needs room. The characters of every cached game share one pool, and
+ * the pool is compacted once more than half of it belongs to forgotten games.
+ */
+class DisplayCache {
+public:
+    // Views into the pool, valid until the next call to get()
+    struct Strings {
+        std::string_view title;
+        std::string_view rating;
+        std::string_view platform;
+        std::string_view genres;
+    };
+
+    // About 30 screens of the main window, a few hundred kilobytes at most
+    static constexpr size_t DEFAULT_CAPACITY = 4096;
+
+    explicit DisplayCache(size_t capacity = DEFAULT_CAPACITY);
+
+    // The game's strings, formatted if the game isn't cached, which may forget another game
+    Strings get(const Game& game);
+
+    void clear();
+
+    // Number of games cached
+    [[nodiscard("Getter")]] size_t size() const;
+
+    [[nodiscard("Getter")]] size_t capacity() const;
+
+    // Bytes of the pool, including those of forgotten games that weren't compacted away yet
+    [[nodiscard("Getter")]] size_t getPoolBytes() const;
+
+    // Titles are cut off at 100 characters and broken with a hyphen after 24 characters, then after every 23
+    static void formatTitle(std::string_view title, std::string& out);
+
+    // The score with two decimals out of 10
+    static void formatRating(double score, std::string& out);
+
+    // Platforms longer than 20 characters are cut off with an ellipsis
+    static void formatPlatform(std::string_view platform, std::string& out);
+
+    // Up to five genres, one per line, each cut off at 20 characters
+    static void formatGenres(const std::vector<std::string>& genres, std::string& out);
+
+private:
+    static constexpr uint32_t NONE_ = UINT32_MAX;
+
+    // A cached game: where its strings are in the pool, and its neighbours in recency order
+    struct Entry_ {
+        const Game* game = nullptr;
+        uint32_t offset = 0;
+        uint16_t titleLength = 0;
+        uint16_t ratingLength = 0;
+        uint16_t platformLength = 0;
+        uint16_t genresLength = 0;
+        uint32_t newer = NONE_;
+        uint32_t older = NONE_;
+
+        [[nodiscard("Getter")]] uint32_t length() const;
+    };
+
+    size_t capacity_;
+    std::vector<Entry_> entries_;
+    std::unordered_map<const Game*, uint32_t> index_;
+    std::string pool_;
+    // Bytes of the pool that belong to forgotten games
+    size_t deadBytes_ = 0;
+    uint32_t newest_ = NONE_;
+    uint32_t oldest_ = NONE_;
+    // Scratch space for formatting, kept so a miss doesn't allocate
+    std::string scratch_;
+
+    void unlink_(uint32_t entry);
+
+    void pushNewest_(uint32_t entry);
+
+    // Copy the strings of every cached game to the front of a fresh pool
+    void compact_();
+
+    [[nodiscard("Getter")]] Strings strings_(const Entry_& entry) const;
+};
@@ -0,0 +1,180 @@
+#include "footprint.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include "allocprofile.hpp"
+
+namespace {
+    std::atomic<bool> reportsEnabled_{false};
+
+    // Everything malloc uses for a block of the requested size beyond the size itself
+    size_t mallocOverhead_(const void* block, const size_t requested) {
+#ifdef __GLIBC__
+        // malloc_usable_size counts the rounding, every chunk also carries one size_t of header
+        return malloc_usable_size(const_cast<void*>(block)) - requested + sizeof(size_t);
+#else
+        (void) block;
+        (void) requested;
+        return 0;
+#endif
+    }
+
+    // True if the blocks of operator new are malloc's own, so that malloc can be asked about them
+    constexpr bool canInspectMalloc_() {
+#ifdef __GLIBC__
+        return !heap::ENABLED;
+#else
+        return false;
+#endif
+    }
+
+    // Sum the "Rss:" and "Pss:" lines of an smaps file, in kB
+    bool readSmaps_(const char* path, size_t& rssKilobytes, size_t& pssKilobytes) {
+        std::ifstream smaps(path);
+        if (!smaps.is_open()) {
+            return false;
+        }
+        std::string line;
+        while (std::getline(smaps, line)) {
+            size_t kilobytes = 0;
+            if (std::sscanf(line.c_str(), "Rss: %zu kB", &kilobytes) == 1) {
+                rssKilobytes += kilobytes;
+            } else if (std::sscanf(line.c_str(), "Pss: %zu kB", &kilobytes) == 1) {
+                pssKilobytes += kilobytes;
+            }
+        }
+        return true;
+    }
+}
+
+namespace footprint {
+    size_t MemoryFootprint::total() const {
+        return gameObjects + titles + platforms + genreVectors + genreStrings + pointerVectors + mallocOverhead;
+    }
+
+    MemoryFootprint measureFootprint(const std::vector<Game*>& games,
+                                     const std::vector<const std::vector<Game*>*>& pointerVectors) {
+        MemoryFootprint footprint;
+        footprint.games = games.size();
+        footprint.mallocOverheadKnown = canInspectMalloc_();
+        const auto addBlock = [&footprint](const void* block, const size_t bytes) {
+            ++footprint.allocations;
+            if constexpr (canInspectMalloc_()) {
+                footprint.mallocOverhead += mallocOverhead_(block, bytes);
+            }
+        };
+
+        for (const Game* game : games) {
+            footprint.gameObjects += sizeof(Game);
+            addBlock(game, sizeof(Game));
+            game->forEachHeapBlock([&](const Game::HeapPart part, const void* block, const size_t bytes) {
+                switch (part) {
+                    case Game::HeapPart::Title:
+                        footprint.titles += bytes;
+                        break;
+                    case Game::HeapPart::GenreVector:
+                        footprint.genreVectors += bytes;
+                        break;
+                    case Game::HeapPart::GenreString:
+                        footprint.genreStrings += bytes;
+                        break;
+                    case Game::HeapPart::Platform:
+                        footprint.platforms += bytes;
+                        break;
+                }
+                addBlock(block, bytes);
+            });
+        }
+
+        for (const auto* pointers : pointerVectors) {
+            ++footprint.pointerVectorCount;
+            if (pointers->capacity() > 0) {
+                footprint.pointerVectors += pointers->capacity() * sizeof(Game*);
+                addBlock(pointers->data(), pointers->capacity() * sizeof(Game*));
+            }
+        }
+        readProcessMemory(footprint.rssBytes, footprint.pssBytes);
+        return footprint;
+    }
+
+    void readProcessMemory(size_t& rssBytes, size_t& pssBytes) {
+        size_t rssKilobytes = 0;
+        size_t pssKilobytes = 0;
+        // smaps_rollup is the kernel's own sum of smaps, much cheaper where it exists (Linux 4.14+)
+        if (!readSmaps_("/proc/self/smaps_rollup", rssKilobytes, pssKilobytes)) {
+            readSmaps_("/proc/self/smaps", rssKilobytes, pssKilobytes);
+        }
+        rssBytes = rssKilobytes * 1024;
+        pssBytes = pssKilobytes * 1024;
+    }
+
+    void printFootprint(std::ostream& out, const std::string& label, const MemoryFootprint& footprint) {
+        const double games = footprint.games == 0 ? 1.0 : static_cast<double>(footprint.games);
+        char line[160];
+        out << "memory " << label << ": " << footprint.games << " games, " << footprint.allocations
+            << " allocations\n";
+        const auto printRow = [&](const char* component, const size_t bytes) {
+            std::snprintf(line, sizeof(line), "  %-24s %14zu bytes %10.1f per game\n", component, bytes,
+                          static_cast<double>(bytes) / games);
+            out << line;
+        };
+        printRow("Game objects", footprint.gameObjects);
+        printRow("titles", footprint.titles);
+        printRow("platforms", footprint.platforms);
+        printRow("genre vectors", footprint.genreVectors);
+        printRow("genre strings", footprint.genreStrings);
+        const std::string vectors = "pointer vectors (" + std::to_string(footprint.pointerVectorCount) + ")";
+        printRow(vectors.c_str(), footprint.pointerVectors);
+        if (footprint.mallocOverheadKnown) {
+            printRow("malloc overhead", footprint.mallocOverhead);
+        }
+        printRow("total", footprint.total());
+        if (footprint.rssBytes > 0) {
+            std::snprintf(line, sizeof(line), "  process RSS %.1f MiB, PSS %.1f MiB\n",
+                          static_cast<double>(footprint.rssBytes) / (1024.0 * 1024.0),
+                          static_cast<double>(footprint.pssBytes) / (1024.0 * 1024.0));
+            out << line;
+        }
+    }
+
+    std::string footprintJson(const MemoryFootprint& footprint) {
+        std::ostringstream json;
+        json << "{\"games\": " << footprint.games << ", \"allocations\": " << footprint.allocations
+             << ", \"game_objects\": " << footprint.gameObjects << ", \"titles\": " << footprint.titles
+             << ", \"platforms\": " << footprint.platforms << ", \"genre_vectors\": " << footprint.genreVectors
+             << ", \"genre_strings\": " << footprint.genreStrings << ", \"pointer_vectors\": "
+             << footprint.pointerVectors << ", \"pointer_vector_count\": " << footprint.pointerVectorCount
+             << ", \"malloc_overhead\": ";
+        if (footprint.mallocOverheadKnown) {
+            json << footprint.mallocOverhead;
+        } else {
+            json << "null";
+        }
+        json << ", \"total\": " << footprint.total() << ", \"rss_bytes\": " << footprint.rssBytes
+             << ", \"pss_bytes\": " << footprint.pssBytes << '}';
+        return json.str();
+    }
+
+    void enableReports() {
+        reportsEnabled_.store(true, std::memory_order_relaxed);
+    }
+
+    bool reportsEnabled() {
+        return reportsEnabled_.load(std::memory_order_relaxed);
+    }
+
+    void report(const std::string& label, const std::vector<Game*>& games,
+                const std::vector<const std::vector<Game*>*>& pointerVectors) {
+        if (reportsEnabled()) {
+            printFootprint(std::cerr, label, measureFootprint(games, pointerVectors));
+        }
+    }
+}
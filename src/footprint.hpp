@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Game.hpp"
+
+/*
+ * Memory footprint of the loaded games, by component, next to what the process actually holds.
+ */
+namespace footprint {
+    /**
+     * @brief Bytes used by a set of games and the vectors that point to them
+     *
+     * Component sizes are what was requested from the allocator. mallocOverhead is
+     * what glibc adds on top: rounding up to its size classes and a chunk header per
+     * allocation. It is only known for glibc builds without GAMESORT_INSTRUMENT, whose
+     * operator new doesn't hand out malloc's own blocks.
+     *
+     * rssBytes and pssBytes are the whole process as reported by /proc/self/smaps,
+     * 0 where it doesn't exist. PSS splits shared pages among the processes sharing them.
+     */
+    struct MemoryFootprint {
+        size_t games = 0;
+        size_t gameObjects = 0;
+        size_t titles = 0;
+        size_t platforms = 0;
+        size_t genreVectors = 0;
+        size_t genreStrings = 0;
+        size_t pointerVectors = 0;
+        size_t pointerVectorCount = 0;
+        size_t allocations = 0;
+        size_t mallocOverhead = 0;
+        bool mallocOverheadKnown = false;
+        size_t rssBytes = 0;
+        size_t pssBytes = 0;
+
+        // Every component and the malloc overhead
+        [[nodiscard]] size_t total() const;
+    };
+
+    /**
+     * @brief Measure games and every vector of pointers to them
+     *
+     * @param games The games, each counted once
+     * @param pointerVectors Vectors of Game pointers to count the buffers of, e.g. the
+     * loaded games and the copies each sort works on. Can include games itself.
+     */
+    MemoryFootprint measureFootprint(const std::vector<Game*>& games,
+                                     const std::vector<const std::vector<Game*>*>& pointerVectors);
+
+    // Resident and proportional set size of the process, 0 where /proc/self/smaps is missing
+    void readProcessMemory(size_t& rssBytes, size_t& pssBytes);
+
+    // Print a table of the components with bytes per game, labelled e.g. "after loading"
+    void printFootprint(std::ostream& out, const std::string& label, const MemoryFootprint& footprint);
+
+    // Write a footprint as a JSON object
+    std::string footprintJson(const MemoryFootprint& footprint);
+
+    // Turn on report(), e.g. from a command line flag
+    void enableReports();
+
+    bool reportsEnabled();
+
+    /**
+     * @brief Measure and print a footprint to stderr if reports are enabled
+     *
+     * Lets code deep in the program report the vectors it holds without threading
+     * a flag through every caller.
+     */
+    void report(const std::string& label, const std::vector<Game*>& games,
+                const std::vector<const std::vector<Game*>*>& pointerVectors);
+}
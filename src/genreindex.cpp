@@ -0,0 +1,184 @@
+#include "genreindex.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+    void skipSpaces_(std::string_view& rest) {
+        while (!rest.empty() && (rest.front() == ' ' || rest.front() == '\t')) {
+            rest.remove_prefix(1);
+        }
+    }
+
+    // A keyword only counts as a whole word, so genres like "Notable" or "ORder" stay names
+    bool startsWithKeyword_(const std::string_view rest, const std::string_view keyword) {
+        return rest.starts_with(keyword) &&
+               (rest.size() == keyword.size() || rest[keyword.size()] == ' ' || rest[keyword.size()] == '\t' ||
+                rest[keyword.size()] == '(' || rest[keyword.size()] == ')' || rest[keyword.size()] == '"');
+    }
+
+    // Consume the keyword if it is next
+    bool acceptKeyword_(std::string_view& rest, const std::string_view keyword) {
+        skipSpaces_(rest);
+        if (!startsWithKeyword_(rest, keyword)) {
+            return false;
+        }
+        rest.remove_prefix(keyword.size());
+        return true;
+    }
+
+    bool startsWithAnyKeyword_(const std::string_view rest) {
+        return startsWithKeyword_(rest, "AND") || startsWithKeyword_(rest, "OR") || startsWithKeyword_(rest, "NOT");
+    }
+}
+
+GenreIndex::GenreIndex(const std::vector<Game*>& games) : games_(games) {
+    if (games.size() > std::numeric_limits<uint32_t>::max()) {
+        throw std::invalid_argument("The genre index holds at most 2^32 games");
+    }
+    // Ids come in ascending order, so every bitmap only ever appends
+    for (size_t id = 0; id < games.size(); ++id) {
+        for (const auto& genre : games[id]->get_genres()) {
+            genres_[genre].add(static_cast<uint32_t>(id));
+        }
+    }
+    all_ = IdBitmap::range(static_cast<uint32_t>(games.size()));
+}
+
+size_t GenreIndex::size() const {
+    return games_.size();
+}
+
+std::vector<std::string> GenreIndex::getGenres() const {
+    std::vector<std::string> genres;
+    genres.reserve(genres_.size());
+    for (const auto& [genre, ids] : genres_) {
+        genres.push_back(genre);
+    }
+    std::ranges::sort(genres);
+    return genres;
+}
+
+const IdBitmap& GenreIndex::getGenre(const std::string_view genre) const {
+    const auto found = genres_.find(std::string(genre));
+    if (found == genres_.end()) {
+        throw std::invalid_argument("No game has the genre \"" + std::string(genre) + "\"");
+    }
+    return found->second;
+}
+
+IdBitmap GenreIndex::query(const std::string_view expression) const {
+    return evaluate(GenreQuery(expression));
+}
+
+IdBitmap GenreIndex::evaluate(const GenreQuery& query) const {
+    std::vector<IdBitmap> operands;
+    for (const auto& step : query.steps_) {
+        if (step.op == GenreQuery::Op_::Genre) {
+            operands.push_back(getGenre(step.genre));
+            continue;
+        }
+        IdBitmap rhs = std::move(operands.back());
+        operands.pop_back();
+        switch (step.op) {
+            case GenreQuery::Op_::Not:
+                operands.push_back(all_.andNot(rhs));
+                break;
+            case GenreQuery::Op_::And:
+                operands.back() = operands.back() & rhs;
+                break;
+            case GenreQuery::Op_::Or:
+                operands.back() = operands.back() | rhs;
+                break;
+            case GenreQuery::Op_::AndNot:
+                operands.back() = operands.back().andNot(rhs);
+                break;
+            case GenreQuery::Op_::Genre:
+                break;
+        }
+    }
+    return std::move(operands.back());
+}
+
+std::vector<Game*> GenreIndex::select(const IdBitmap& ids) const {
+    std::vector<Game*> games;
+    games.reserve(ids.cardinality());
+    ids.forEach([&](const uint32_t id) {
+        games.push_back(games_.at(id));
+    });
+    return games;
+}
+
+GenreQuery::GenreQuery(const std::string_view expression) {
+    std::string_view rest = expression;
+    parseOr_(rest);
+    skipSpaces_(rest);
+    if (!rest.empty()) {
+        throw std::invalid_argument("Unexpected \"" + std::string(rest) + "\" in the genre query");
+    }
+}
+
+void GenreQuery::parseOr_(std::string_view& rest) {
+    parseAnd_(rest);
+    while (acceptKeyword_(rest, "OR")) {
+        parseAnd_(rest);
+        steps_.push_back({Op_::Or, {}});
+    }
+}
+
+void GenreQuery::parseAnd_(std::string_view& rest) {
+    parseNot_(rest);
+    while (acceptKeyword_(rest, "AND")) {
+        const bool negated = acceptKeyword_(rest, "NOT");
+        parseNot_(rest);
+        steps_.push_back({negated ? Op_::AndNot : Op_::And, {}});
+    }
+}
+
+void GenreQuery::parseNot_(std::string_view& rest) {
+    if (acceptKeyword_(rest, "NOT")) {
+        parseNot_(rest);
+        steps_.push_back({Op_::Not, {}});
+        return;
+    }
+    skipSpaces_(rest);
+    if (rest.starts_with('(')) {
+        rest.remove_prefix(1);
+        parseOr_(rest);
+        skipSpaces_(rest);
+        if (!rest.starts_with(')')) {
+            throw std::invalid_argument("Missing ) in the genre query");
+        }
+        rest.remove_prefix(1);
+        return;
+    }
+    if (rest.starts_with('"')) {
+        const size_t end = rest.find('"', 1);
+        if (end == std::string_view::npos) {
+            throw std::invalid_argument("Missing \" in the genre query");
+        }
+        const std::string_view genre = rest.substr(1, end - 1);
+        rest.remove_prefix(end + 1);
+        steps_.push_back({Op_::Genre, std::string(genre)});
+        return;
+    }
+
+    // Every word up to the next keyword, parenthesis or the end
+    std::string_view genre = rest;
+    size_t length = 0;
+    while (length < rest.size() && rest[length] != '(' && rest[length] != ')' && rest[length] != '"' &&
+           !((length == 0 || rest[length - 1] == ' ' || rest[length - 1] == '\t') &&
+             startsWithAnyKeyword_(rest.substr(length)))) {
+        ++length;
+    }
+    genre = genre.substr(0, length);
+    while (!genre.empty() && (genre.back() == ' ' || genre.back() == '\t')) {
+        genre.remove_suffix(1);
+    }
+    if (genre.empty()) {
+        throw std::invalid_argument("Expected a genre in the genre query");
+    }
+    rest.remove_prefix(length);
+    steps_.push_back({Op_::Genre, std::string(genre)});
+}
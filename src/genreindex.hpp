@@ -0,0 +1,93 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Game.hpp"
+#include "idbitmap.hpp"
+
+/**
+ * @brief A genre query parsed ahead of the games it is run on, see GenreIndex for the syntax
+ *
+ * Parsing doesn't need the games, so a malformed query is rejected before anything is
+ * loaded. Only unknown genres are left for GenreIndex::evaluate() to find.
+ */
+class GenreQuery {
+public:
+    // Throws std::invalid_argument if the expression doesn't parse
+    explicit GenreQuery(std::string_view expression);
+
+private:
+    friend class GenreIndex;
+
+    enum class Op_ {
+        Genre,
+        And,
+        Or,
+        Not,
+        // "A AND NOT B", subtracts B from A directly instead of intersecting with everything but B
+        AndNot
+    };
+
+    struct Step_ {
+        Op_ op;
+        // Only set for Op_::Genre
+        std::string genre;
+    };
+
+    // The query in postfix order, operators after their operands
+    std::vector<Step_> steps_;
+
+    // Recursive descent over the query, each consumes what it parsed from the front of rest
+    void parseOr_(std::string_view& rest);
+
+    void parseAnd_(std::string_view& rest);
+
+    void parseNot_(std::string_view& rest);
+};
+
+/**
+ * @brief Inverted index from each genre to the games that have it
+ *
+ * A game's id is its position in the vector the index was built from, and every genre
+ * maps to an IdBitmap of those ids. Queries combine the genres' bitmaps, so they cost
+ * about the size of the bitmaps instead of a scan over every game's genre strings.
+ *
+ * A query is genres joined with AND, OR and NOT, with parentheses for grouping. AND binds
+ * tighter than OR. Keywords are upper case. A genre is the words between keywords, or a
+ * quoted string for genres with parentheses in their name:
+ *
+ *     Action AND Shooter AND NOT Licensed
+ *     "Role-playing (RPG)" AND (Fantasy OR Sci-fi / futuristic)
+ */
+class GenreIndex {
+public:
+    // Indexes the genres of the games, which must outlive the index
+    explicit GenreIndex(const std::vector<Game*>& games);
+
+    // Number of games indexed
+    [[nodiscard("Getter")]] size_t size() const;
+
+    // Every genre that at least one game has, in alphabetical order
+    [[nodiscard("Getter")]] std::vector<std::string> getGenres() const;
+
+    // The games with a genre, throws std::invalid_argument for a genre no game has
+    [[nodiscard("Getter")]] const IdBitmap& getGenre(std::string_view genre) const;
+
+    // Evaluate a query, throws std::invalid_argument if it doesn't parse or names an unknown genre
+    [[nodiscard("Getter")]] IdBitmap query(std::string_view expression) const;
+
+    // Evaluate a parsed query, throws std::invalid_argument if it names an unknown genre
+    [[nodiscard("Getter")]] IdBitmap evaluate(const GenreQuery& query) const;
+
+    // The games of a query result in the order they were indexed, ready to display or sort
+    [[nodiscard("Getter")]] std::vector<Game*> select(const IdBitmap& ids) const;
+
+private:
+    std::vector<Game*> games_;
+    std::unordered_map<std::string, IdBitmap> genres_;
+    // Every id, NOT subtracts from it
+    IdBitmap all_;
+};
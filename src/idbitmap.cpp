@@ -0,0 +1,252 @@
+#include "idbitmap.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <iterator>
+
+IdBitmap IdBitmap::range(const uint32_t count) {
+    IdBitmap bitmap;
+    for (uint64_t start = 0; start < count; start += 65536) {
+        const auto size = static_cast<uint32_t>(std::min<uint64_t>(65536, count - start));
+        std::vector<uint64_t> bits(WORDS_, 0);
+        std::fill_n(bits.begin(), size / 64, ~0ULL);
+        if (size % 64 != 0) {
+            bits[size / 64] = (1ULL << (size % 64)) - 1;
+        }
+        bitmap.containers_.push_back(fromBits_(static_cast<uint16_t>(start >> 16), std::move(bits)));
+    }
+    return bitmap;
+}
+
+void IdBitmap::add(const uint32_t id) {
+    const auto key = static_cast<uint16_t>(id >> 16);
+    const auto low = static_cast<uint16_t>(id & 0xFFFF);
+    auto container = containers_.end();
+    if (containers_.empty() || containers_.back().key < key) {
+        container = containers_.emplace(containers_.end());
+        container->key = key;
+    } else {
+        container = std::ranges::lower_bound(containers_, key, {}, &Container_::key);
+        if (container->key != key) {
+            container = containers_.emplace(container);
+            container->key = key;
+        }
+    }
+
+    if (container->isBitmap()) {
+        uint64_t& word = container->bits[low >> 6];
+        const uint64_t bit = 1ULL << (low & 63);
+        container->cardinality += (word & bit) == 0 ? 1 : 0;
+        word |= bit;
+        return;
+    }
+    // Ascending ids are appended, anything else is inserted in place
+    auto& array = container->array;
+    if (array.empty() || array.back() < low) {
+        array.push_back(low);
+    } else {
+        const auto position = std::ranges::lower_bound(array, low);
+        if (*position == low) {
+            return;
+        }
+        array.insert(position, low);
+    }
+    ++container->cardinality;
+    if (container->cardinality > ARRAY_LIMIT_) {
+        container->bits = toBits_(*container);
+        container->array = std::vector<uint16_t>();
+    }
+}
+
+bool IdBitmap::contains(const uint32_t id) const {
+    const auto key = static_cast<uint16_t>(id >> 16);
+    const auto low = static_cast<uint16_t>(id & 0xFFFF);
+    const auto container = std::ranges::lower_bound(containers_, key, {}, &Container_::key);
+    if (container == containers_.end() || container->key != key) {
+        return false;
+    }
+    if (container->isBitmap()) {
+        return (container->bits[low >> 6] >> (low & 63) & 1) != 0;
+    }
+    return std::ranges::binary_search(container->array, low);
+}
+
+uint64_t IdBitmap::cardinality() const {
+    uint64_t cardinality = 0;
+    for (const auto& container : containers_) {
+        cardinality += container.cardinality;
+    }
+    return cardinality;
+}
+
+bool IdBitmap::empty() const {
+    return containers_.empty();
+}
+
+size_t IdBitmap::getBytes() const {
+    size_t bytes = containers_.capacity() * sizeof(Container_);
+    for (const auto& container : containers_) {
+        bytes += container.array.capacity() * sizeof(uint16_t) + container.bits.capacity() * sizeof(uint64_t);
+    }
+    return bytes;
+}
+
+IdBitmap IdBitmap::operator&(const IdBitmap& rhs) const {
+    IdBitmap result;
+    auto left = containers_.begin();
+    auto right = rhs.containers_.begin();
+    // Only keys in both sets can have ids in the intersection
+    while (left != containers_.end() && right != rhs.containers_.end()) {
+        if (left->key < right->key) {
+            ++left;
+        } else if (right->key < left->key) {
+            ++right;
+        } else {
+            Container_ container = intersect_(*left++, *right++);
+            if (container.cardinality > 0) {
+                result.containers_.push_back(std::move(container));
+            }
+        }
+    }
+    return result;
+}
+
+IdBitmap IdBitmap::operator|(const IdBitmap& rhs) const {
+    IdBitmap result;
+    auto left = containers_.begin();
+    auto right = rhs.containers_.begin();
+    while (left != containers_.end() || right != rhs.containers_.end()) {
+        if (right == rhs.containers_.end() || (left != containers_.end() && left->key < right->key)) {
+            result.containers_.push_back(*left++);
+        } else if (left == containers_.end() || right->key < left->key) {
+            result.containers_.push_back(*right++);
+        } else {
+            result.containers_.push_back(unite_(*left++, *right++));
+        }
+    }
+    return result;
+}
+
+IdBitmap IdBitmap::andNot(const IdBitmap& rhs) const {
+    IdBitmap result;
+    auto right = rhs.containers_.begin();
+    for (const auto& left : containers_) {
+        while (right != rhs.containers_.end() && right->key < left.key) {
+            ++right;
+        }
+        if (right == rhs.containers_.end() || right->key != left.key) {
+            result.containers_.push_back(left);
+            continue;
+        }
+        Container_ container = subtract_(left, *right);
+        if (container.cardinality > 0) {
+            result.containers_.push_back(std::move(container));
+        }
+    }
+    return result;
+}
+
+std::vector<uint32_t> IdBitmap::toVector() const {
+    std::vector<uint32_t> ids;
+    ids.reserve(cardinality());
+    forEach([&](const uint32_t id) {
+        ids.push_back(id);
+    });
+    return ids;
+}
+
+bool IdBitmap::Container_::isBitmap() const {
+    return !bits.empty();
+}
+
+std::vector<uint64_t> IdBitmap::toBits_(const Container_& container) {
+    if (container.isBitmap()) {
+        return container.bits;
+    }
+    std::vector<uint64_t> bits(WORDS_, 0);
+    for (const uint16_t low : container.array) {
+        bits[low >> 6] |= 1ULL << (low & 63);
+    }
+    return bits;
+}
+
+IdBitmap::Container_ IdBitmap::fromBits_(const uint16_t key, std::vector<uint64_t> bits) {
+    Container_ container;
+    container.key = key;
+    for (const uint64_t word : bits) {
+        container.cardinality += static_cast<uint32_t>(std::popcount(word));
+    }
+    if (container.cardinality > ARRAY_LIMIT_) {
+        container.bits = std::move(bits);
+        return container;
+    }
+    container.array.reserve(container.cardinality);
+    for (uint32_t word = 0; word < WORDS_; ++word) {
+        for (uint64_t remaining = bits[word]; remaining != 0; remaining &= remaining - 1) {
+            container.array.push_back(static_cast<uint16_t>((word << 6) | std::countr_zero(remaining)));
+        }
+    }
+    return container;
+}
+
+IdBitmap::Container_ IdBitmap::intersect_(const Container_& lhs, const Container_& rhs) {
+    Container_ container;
+    container.key = lhs.key;
+    if (!lhs.isBitmap() && !rhs.isBitmap()) {
+        std::ranges::set_intersection(lhs.array, rhs.array, std::back_inserter(container.array));
+    } else if (!lhs.isBitmap() || !rhs.isBitmap()) {
+        // Test each id of the array against the bitmap
+        const Container_& array = lhs.isBitmap() ? rhs : lhs;
+        const Container_& bitmap = lhs.isBitmap() ? lhs : rhs;
+        std::ranges::copy_if(array.array, std::back_inserter(container.array), [&](const uint16_t low) {
+            return (bitmap.bits[low >> 6] >> (low & 63) & 1) != 0;
+        });
+    } else {
+        std::vector<uint64_t> bits(WORDS_);
+        for (uint32_t word = 0; word < WORDS_; ++word) {
+            bits[word] = lhs.bits[word] & rhs.bits[word];
+        }
+        return fromBits_(lhs.key, std::move(bits));
+    }
+    container.cardinality = static_cast<uint32_t>(container.array.size());
+    return container;
+}
+
+IdBitmap::Container_ IdBitmap::unite_(const Container_& lhs, const Container_& rhs) {
+    if (!lhs.isBitmap() && !rhs.isBitmap() && lhs.cardinality + rhs.cardinality <= ARRAY_LIMIT_) {
+        Container_ container;
+        container.key = lhs.key;
+        std::ranges::set_union(lhs.array, rhs.array, std::back_inserter(container.array));
+        container.cardinality = static_cast<uint32_t>(container.array.size());
+        return container;
+    }
+    std::vector<uint64_t> bits = toBits_(lhs);
+    const std::vector<uint64_t> rhsBits = toBits_(rhs);
+    for (uint32_t word = 0; word < WORDS_; ++word) {
+        bits[word] |= rhsBits[word];
+    }
+    return fromBits_(lhs.key, std::move(bits));
+}
+
+IdBitmap::Container_ IdBitmap::subtract_(const Container_& lhs, const Container_& rhs) {
+    if (!lhs.isBitmap()) {
+        // At most as many ids as the array, so the result stays an array
+        Container_ container;
+        container.key = lhs.key;
+        if (rhs.isBitmap()) {
+            std::ranges::copy_if(lhs.array, std::back_inserter(container.array), [&](const uint16_t low) {
+                return (rhs.bits[low >> 6] >> (low & 63) & 1) == 0;
+            });
+        } else {
+            std::ranges::set_difference(lhs.array, rhs.array, std::back_inserter(container.array));
+        }
+        container.cardinality = static_cast<uint32_t>(container.array.size());
+        return container;
+    }
+    std::vector<uint64_t> bits = lhs.bits;
+    const std::vector<uint64_t> rhsBits = toBits_(rhs);
+    for (uint32_t word = 0; word < WORDS_; ++word) {
+        bits[word] &= ~rhsBits[word];
+    }
+    return fromBits_(lhs.key, std::move(bits));
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Compressed set of 32-bit ids in the style of Roaring bitmaps
+ *
+ * Ids are grouped by their upper 16 bits into containers of up to 65536 ids. A container
+ * with at most 4096 ids is a sorted array of their lower 16 bits, a fuller one is a bitmap
+ * of 1024 64-bit words. So a sparse set costs 2 bytes per id and a dense one at most
+ * 8 kilobytes per 65536 ids, and the set operations work a container at a time, a word
+ * at a time between bitmaps, in loops the compiler vectorizes.
+ */
+class IdBitmap {
+public:
+    IdBitmap() = default;
+
+    // Every id from 0 to count - 1
+    static IdBitmap range(uint32_t count);
+
+    // Cheapest when the ids come in ascending order
+    void add(uint32_t id);
+
+    [[nodiscard("Getter")]] bool contains(uint32_t id) const;
+
+    [[nodiscard("Getter")]] uint64_t cardinality() const;
+
+    [[nodiscard("Getter")]] bool empty() const;
+
+    // Bytes used by the containers
+    [[nodiscard("Getter")]] size_t getBytes() const;
+
+    IdBitmap operator&(const IdBitmap& rhs) const;
+
+    IdBitmap operator|(const IdBitmap& rhs) const;
+
+    // The ids of this set that aren't in rhs
+    [[nodiscard("Getter")]] IdBitmap andNot(const IdBitmap& rhs) const;
+
+    // Call visit(id) for every id in ascending order
+    template<typename Visit>
+    void forEach(Visit&& visit) const {
+        for (const auto& container : containers_) {
+            const uint32_t high = static_cast<uint32_t>(container.key) << 16;
+            if (!container.isBitmap()) {
+                for (const uint16_t low : container.array) {
+                    visit(high | low);
+                }
+                continue;
+            }
+            for (uint32_t word = 0; word < WORDS_; ++word) {
+                for (uint64_t bits = container.bits[word]; bits != 0; bits &= bits - 1) {
+                    visit(high | (word << 6) | static_cast<uint32_t>(std::countr_zero(bits)));
+                }
+            }
+        }
+    }
+
+    [[nodiscard("Getter")]] std::vector<uint32_t> toVector() const;
+
+private:
+    static constexpr uint32_t ARRAY_LIMIT_ = 4096;
+    static constexpr uint32_t WORDS_ = 65536 / 64;
+
+    // The ids whose upper 16 bits are key, as an array or as a bitmap, never both
+    struct Container_ {
+        uint16_t key = 0;
+        uint32_t cardinality = 0;
+        std::vector<uint16_t> array;
+        std::vector<uint64_t> bits;
+
+        [[nodiscard("Getter")]] bool isBitmap() const;
+    };
+
+    // Sorted by key, none of them empty
+    std::vector<Container_> containers_;
+
+    // The container's ids as a bitmap, whichever form it is in
+    static std::vector<uint64_t> toBits_(const Container_& container);
+
+    // Store the bits in the cheaper form for their cardinality
+    static Container_ fromBits_(uint16_t key, std::vector<uint64_t> bits);
+
+    static Container_ intersect_(const Container_& lhs, const Container_& rhs);
+
+    static Container_ unite_(const Container_& lhs, const Container_& rhs);
+
+    static Container_ subtract_(const Container_& lhs, const Container_& rhs);
+};
@@ -0,0 +1,129 @@
+#include "inputorder.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+
+namespace {
+    // Number of distinct games in an InputOrder::FewUnique input
+    constexpr size_t FEW_UNIQUE_KEYS = 16;
+
+    std::vector<Game*> sortedCopy_(const std::vector<Game*>& games, const GameComparator comparator) {
+        std::vector<Game*> sorted = games;
+        std::ranges::stable_sort(sorted.begin(), sorted.end(), comparator);
+        return sorted;
+    }
+
+    // A comparator for a different field than target, so the input is ordered but not in the target order
+    GameComparator otherComparator_(const SortComparator& target) {
+        return target.compare == Game::compareTitles ? Game::compareScores : Game::compareTitles;
+    }
+}
+
+const std::array<InputOrder, 7> INPUT_ORDERS = {
+    InputOrder::Random, InputOrder::Sorted, InputOrder::Reversed, InputOrder::SortedByOther,
+    InputOrder::FewUnique, InputOrder::OrganPipe, InputOrder::Perturbed
+};
+
+const char* inputOrderName(const InputOrder order) {
+    switch (order) {
+        case InputOrder::Sorted:
+            return "sorted";
+        case InputOrder::Reversed:
+            return "reversed";
+        case InputOrder::SortedByOther:
+            return "sorted_other";
+        case InputOrder::FewUnique:
+            return "few_unique";
+        case InputOrder::OrganPipe:
+            return "organ_pipe";
+        case InputOrder::Perturbed:
+            return "perturbed";
+        case InputOrder::Random:
+        default:
+            return "random";
+    }
+}
+
+ArrangedInput arrangeInput(const std::vector<Game*>& games, const InputOrder order, const SortComparator& target,
+                           const uint64_t seed, const double perturbedFraction) {
+    std::mt19937_64 generator(seed);
+    switch (order) {
+        case InputOrder::Sorted:
+            return {sortedCopy_(games, target.compare)};
+        case InputOrder::Reversed: {
+            std::vector<Game*> reversed = sortedCopy_(games, target.compare);
+            std::ranges::reverse(reversed.begin(), reversed.end());
+            return {std::move(reversed)};
+        }
+        case InputOrder::SortedByOther:
+            return {sortedCopy_(games, otherComparator_(target))};
+        case InputOrder::FewUnique: {
+            if (games.empty()) {
+                return {};
+            }
+            std::vector<Game*> keys;
+            std::ranges::sample(games.begin(), games.end(), std::back_inserter(keys), FEW_UNIQUE_KEYS, generator);
+            std::uniform_int_distribution<size_t> pick(0, keys.size() - 1);
+            // Copies rather than the same pointers, so that a stable sort's order of equal games is visible
+            ArrangedInput fewUnique;
+            fewUnique.games.reserve(games.size());
+            fewUnique.copies.reserve(games.size());
+            for (size_t i = 0; i < games.size(); ++i) {
+                fewUnique.copies.push_back(std::make_unique<Game>(*keys[pick(generator)]));
+                fewUnique.games.push_back(fewUnique.copies.back().get());
+            }
+            return fewUnique;
+        }
+        case InputOrder::OrganPipe: {
+            // Even ranks fill the front in ascending order, odd ranks fill the back in descending order
+            const std::vector<Game*> sorted = sortedCopy_(games, target.compare);
+            std::vector<Game*> organPipe(sorted.size());
+            size_t front = 0;
+            size_t back = sorted.size();
+            for (size_t rank = 0; rank < sorted.size(); ++rank) {
+                if (rank % 2 == 0) {
+                    organPipe[front++] = sorted[rank];
+                } else {
+                    organPipe[--back] = sorted[rank];
+                }
+            }
+            return {std::move(organPipe)};
+        }
+        case InputOrder::Perturbed: {
+            std::vector<Game*> perturbed = sortedCopy_(games, target.compare);
+            perturbGames(perturbed, perturbedFraction, generator);
+            return {std::move(perturbed)};
+        }
+        case InputOrder::Random:
+        default: {
+            std::vector<Game*> shuffled = games;
+            std::ranges::shuffle(shuffled.begin(), shuffled.end(), generator);
+            return {std::move(shuffled)};
+        }
+    }
+}
+
+void perturbGames(std::vector<Game*>& games, const double fraction, std::mt19937_64& generator) {
+    const auto displaced = static_cast<size_t>(static_cast<double>(games.size()) * std::clamp(fraction, 0.0, 1.0));
+    if (displaced < 2) {
+        return;
+    }
+    std::vector<size_t> positions(games.size());
+    for (size_t i = 0; i < positions.size(); ++i) {
+        positions[i] = i;
+    }
+    // Partial Fisher-Yates: the first `displaced` positions are a uniform random sample
+    for (size_t i = 0; i < displaced; ++i) {
+        std::uniform_int_distribution<size_t> pick(i, positions.size() - 1);
+        std::swap(positions[i], positions[pick(generator)]);
+    }
+    std::vector<Game*> moved(displaced);
+    for (size_t i = 0; i < displaced; ++i) {
+        moved[i] = games[positions[i]];
+    }
+    std::ranges::shuffle(moved.begin(), moved.end(), generator);
+    for (size_t i = 0; i < displaced; ++i) {
+        games[positions[i]] = moved[i];
+    }
+}
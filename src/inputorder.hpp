@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Game.hpp"
+#include "sorts.hpp"
+
+// Orders a sort's input can start in, see arrangeInput()
+enum class InputOrder {
+    Random,
+    Sorted,
+    Reversed,
+    SortedByOther,
+    FewUnique,
+    OrganPipe,
+    Perturbed
+};
+
+extern const std::array<InputOrder, 7> INPUT_ORDERS;
+
+// Short name of an input order, as used on the command line and in benchmark output
+const char* inputOrderName(InputOrder order);
+
+// Games in the order a sort starts from, and the games made for that order
+struct ArrangedInput {
+    std::vector<Game*> games;
+    // Copies that some of the games point to, freed with the input
+    std::vector<std::unique_ptr<Game>> copies;
+};
+
+/**
+ * @brief Arrange games in a controlled starting order for a sort
+ *
+ * @param games Games to arrange, never modified
+ * @param order Starting order
+ * @param target The comparator the input will be sorted with
+ * @param seed Seed for every random choice, the same seed gives the same input
+ * @param perturbedFraction Share of the games displaced by InputOrder::Perturbed, from 0 to 1
+ * @return The games in the requested order, and any copies made for it
+ *
+ * Random: a uniform shuffle.
+ * Sorted, Reversed: already in (reverse) target order.
+ * SortedByOther: sorted by a different field than the target, e.g. by title before sorting by rating.
+ * FewUnique: as many games as the input, each a new copy of one of 16 distinct ones, so most keys are equal
+ * while the games are still different objects and a sort that swaps equal games can be caught.
+ * OrganPipe: ascending to the middle, then descending.
+ * Perturbed: sorted, then a random perturbedFraction of the games is shuffled among their own positions.
+ */
+ArrangedInput arrangeInput(const std::vector<Game*>& games, InputOrder order, const SortComparator& target,
+                           uint64_t seed, double perturbedFraction = 0.05);
+
+/**
+ * @brief Shuffle a random share of the games among their own positions
+ *
+ * @param games Games to perturb in place
+ * @param fraction Share of the games that are displaced, from 0 to 1
+ * @param generator Source of randomness
+ */
+void perturbGames(std::vector<Game*>& games, double fraction, std::mt19937_64& generator);
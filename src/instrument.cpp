@@ -0,0 +1,25 @@
+#include "instrument.hpp"
+
+#ifdef GAMESORT_INSTRUMENT
+namespace {
+    thread_local bool (*countedComparator_)(const Game* lhs, const Game* rhs) = nullptr;
+
+    bool countingTrampoline_(const Game* lhs, const Game* rhs) {
+        instr::countComparison();
+        return countedComparator_(lhs, rhs);
+    }
+}
+
+namespace instr {
+    bool (*countComparisons(bool (*comparator)(const Game* lhs, const Game* rhs)))(const Game* lhs, const Game* rhs) {
+        countedComparator_ = comparator;
+        return countingTrampoline_;
+    }
+}
+#else
+namespace instr {
+    bool (*countComparisons(bool (*comparator)(const Game* lhs, const Game* rhs)))(const Game* lhs, const Game* rhs) {
+        return comparator;
+    }
+}
+#endif
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "Game.hpp"
+
+/*
+ * Operation counters for the sorting algorithms.
+ *
+ * Counting is compiled in with -DGAMESORT_INSTRUMENT (the GAMESORT_INSTRUMENT CMake option). Without it every
+ * function here is an empty inline function and the wrappers forward directly, so release builds pay nothing.
+ * Counters are per thread, so concurrent sorts don't mix their counts.
+ */
+namespace instr {
+    struct SortCounters {
+        uint64_t comparisons = 0;
+        uint64_t moves = 0;
+        uint64_t allocations = 0;
+        uint64_t allocatedBytes = 0;
+    };
+
+    // Counters of the current thread
+    inline SortCounters& counters() {
+        static thread_local SortCounters threadCounters;
+        return threadCounters;
+    }
+
+#ifdef GAMESORT_INSTRUMENT
+    constexpr bool ENABLED = true;
+
+    inline void countComparison() {
+        ++counters().comparisons;
+    }
+
+    inline void countMoves(const size_t moves) {
+        counters().moves += moves;
+    }
+
+    // Heap allocations are counted by the replacement operator new in allocprofile.cpp while this is true
+    inline bool& trackingAllocations() {
+        static thread_local bool tracking = false;
+        return tracking;
+    }
+
+    inline void trackAllocations(const bool enabled) {
+        trackingAllocations() = enabled;
+    }
+#else
+    constexpr bool ENABLED = false;
+
+    inline void countComparison() {}
+
+    inline void countMoves(size_t) {}
+
+    inline void trackAllocations(bool) {}
+#endif
+
+    // Reset the counters of the current thread and start counting allocations
+    inline void beginCounting() {
+        counters() = SortCounters{};
+        trackAllocations(true);
+    }
+
+    // Stop counting allocations and return what was counted since beginCounting()
+    inline SortCounters endCounting() {
+        trackAllocations(false);
+        return counters();
+    }
+
+    /**
+     * @brief Comparator wrapper that counts every call
+     *
+     * Works with any comparator and element type, e.g. as the comparator of std::sort.
+     */
+    template<typename Compare>
+    class CountingComparator {
+    public:
+        explicit CountingComparator(Compare compare) : compare_(std::move(compare)) {}
+
+        template<typename Lhs, typename Rhs>
+        bool operator()(const Lhs& lhs, const Rhs& rhs) const {
+            countComparison();
+            return compare_(lhs, rhs);
+        }
+
+    private:
+        Compare compare_;
+    };
+
+    /**
+     * @brief Element wrapper that counts every copy and move of the value it holds
+     *
+     * Lets algorithms that can't be instrumented from the inside, like std::stable_sort, report their moves.
+     */
+    template<typename T>
+    struct CountedElement {
+        T value;
+
+        CountedElement() = default;
+
+        explicit CountedElement(T element) : value(std::move(element)) {}
+
+        CountedElement(const CountedElement& rhs) : value(rhs.value) {
+            countMoves(1);
+        }
+
+        CountedElement(CountedElement&& rhs) noexcept : value(std::move(rhs.value)) {
+            countMoves(1);
+        }
+
+        CountedElement& operator=(const CountedElement& rhs) {
+            value = rhs.value;
+            countMoves(1);
+            return *this;
+        }
+
+        CountedElement& operator=(CountedElement&& rhs) noexcept {
+            value = std::move(rhs.value);
+            countMoves(1);
+            return *this;
+        }
+    };
+
+    /**
+     * @brief Wrap a Game comparator so that calls through the returned pointer are counted
+     *
+     * The sorts take plain function pointers, so the target is kept per thread and
+     * the returned trampoline forwards to it. Without GAMESORT_INSTRUMENT the
+     * comparator is returned unchanged.
+     */
+    bool (*countComparisons(bool (*comparator)(const Game* lhs, const Game* rhs)))(const Game* lhs, const Game* rhs);
+}
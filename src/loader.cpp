@@ -0,0 +1,382 @@
+#include "loader.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <utility>
+
+// Parse json files. Provided by https://github.com/simdjson/simdjson
+#include "../lib/simdjson.h"
+
+#include "allocprofile.hpp"
+#include "trace.hpp"
+
+namespace {
+    // Size of one NDJSON read window. This bounds the memory used while streaming and the size of a single record
+    constexpr size_t NDJSON_WINDOW_SIZE = 16 * 1024 * 1024;
+
+    std::vector<std::string> loadBlacklist_() {
+        try {
+            return getBlacklist();
+        } catch (std::ifstream::failure& e) {
+            std::cerr << e.what() << "\nblacklist not functional, config/blacklist.csv not found.\n";
+        }
+        return {};
+    }
+
+    using clock_ = std::chrono::steady_clock;
+
+    // Position of a string in RecordBatch_::text
+    struct Span_ {
+        size_t begin = 0;
+        size_t size = 0;
+    };
+
+    // The fields of one record, strings are stored in the batch's text buffer
+    struct RawRecord_ {
+        Span_ title;
+        Span_ platform;
+        size_t genresBegin = 0;
+        size_t genresEnd = 0;
+        uint64_t id = 0;
+        int releaseYear = 0;
+        double score = 0.0;
+    };
+
+    /*
+     * All records of one document or stream window. simdjson reuses its string buffer between the documents of a
+     * stream, so strings are copied into one flat text buffer that is reused for every batch instead of being
+     * allocated per record. Genres are flattened into a single vector of spans.
+     */
+    struct RecordBatch_ {
+        std::vector<RawRecord_> records;
+        std::vector<Span_> genres;
+        std::string text;
+
+        Span_ store(const std::string_view string) {
+            const Span_ span{text.size(), string.size()};
+            text.append(string);
+            return span;
+        }
+
+        [[nodiscard]] std::string_view view(const Span_ span) const {
+            return {text.data() + span.begin, span.size};
+        }
+
+        void clear() {
+            records.clear();
+            genres.clear();
+            text.clear();
+        }
+    };
+
+    /*
+     * Walk the fields of one record once, in document order (id, url, title, genres, release_year, moby_score),
+     * instead of searching the object for each key. Every known key has a distinct length, so one switch on the
+     * length and a single comparison pick the field. Unknown keys and values of an unexpected type are skipped.
+     */
+    void extractRecord_(simdjson::ondemand::object gameJson, RecordBatch_& batch) {
+        RawRecord_& record = batch.records.emplace_back();
+        record.genresBegin = batch.genres.size();
+        for (auto field : gameJson) {
+            const std::string_view key = field.escaped_key();
+            simdjson::ondemand::value value = field.value();
+            switch (key.size()) {
+                case 2:
+                    if (uint64_t id = 0; key == "id" && value.get_uint64().get(id) == simdjson::SUCCESS) {
+                        record.id = id;
+                    }
+                    break;
+                case 5:
+                    if (std::string_view title; key == "title" && value.get_string().get(title) == simdjson::SUCCESS) {
+                        record.title = batch.store(title);
+                    }
+                    break;
+                case 6:
+                    if (key == "genres") {
+                        simdjson::ondemand::array genres;
+                        if (value.get_array().get(genres) != simdjson::SUCCESS) {
+                            break;
+                        }
+                        for (auto genre : genres) {
+                            // Need to make sure that genres is a string before emplacing to avoid simdjson error
+                            std::string_view genreView;
+                            if (genre.get_string().get(genreView) == simdjson::SUCCESS) {
+                                batch.genres.push_back(batch.store(genreView));
+                            }
+                        }
+                    }
+                    break;
+                case 8:
+                    if (std::string_view platform;
+                        key == "platform" && value.get_string().get(platform) == simdjson::SUCCESS) {
+                        record.platform = batch.store(platform);
+                    }
+                    break;
+                case 10:
+                    // null scores stay at 0
+                    if (double score = 0.0; key == "moby_score" && value.get_double().get(score) == simdjson::SUCCESS) {
+                        record.score = score;
+                    }
+                    break;
+                case 12:
+                    if (int64_t year = 0;
+                        key == "release_year" && value.get_int64().get(year) == simdjson::SUCCESS) {
+                        record.releaseYear = static_cast<int>(year);
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+        record.genresEnd = batch.genres.size();
+    }
+
+    // Time, hardware counters, allocations and trace span of one load stage, added to the stage totals when it ends
+    class StageTimer_ {
+    public:
+        // name is the trace span and allocation phase of the stage, e.g. "load parse"
+        explicit StageTimer_(const char* name)
+            : span_(name), phase_(name), timeStart_(clock_::now()), eventsStart_(perf::readCounters()) {}
+
+        void stop(std::chrono::nanoseconds& time, perf::CounterValues& events) {
+            time += clock_::now() - timeStart_;
+            events += perf::readCounters() - eventsStart_;
+            phase_.end();
+            span_.end();
+        }
+
+    private:
+        trace::Span span_;
+        heap::Phase phase_;
+        clock_::time_point timeStart_;
+        perf::CounterValues eventsStart_;
+    };
+
+    // Build a Game for every extracted record, then keep the ones that pass the blacklist
+    void addGames_(const RecordBatch_& batch, const std::string& defaultPlatform,
+                   const std::vector<std::string>& blacklist, std::vector<Game*>& games, LoadStats& stats) {
+        StageTimer_ buildStage("load build");
+        std::vector<Game*> built;
+        built.reserve(batch.records.size());
+        for (const RawRecord_& record : batch.records) {
+            std::vector<std::string> genres;
+            genres.reserve(record.genresEnd - record.genresBegin);
+            for (size_t i = record.genresBegin; i < record.genresEnd; ++i) {
+                genres.emplace_back(batch.view(batch.genres[i]));
+            }
+            built.push_back(new Game(std::string(batch.view(record.title)), std::move(genres), record.score,
+                                     record.platform.size == 0 ? defaultPlatform
+                                                               : std::string(batch.view(record.platform)),
+                                     record.id, record.releaseYear));
+        }
+        buildStage.stop(stats.build, stats.buildEvents);
+
+        StageTimer_ filterStage("load filter");
+        for (Game* game : built) {
+            if (blacklist.empty() || !isBlacklisted(game, blacklist)) {
+                games.push_back(game);
+            } else {
+                delete game;
+            }
+        }
+        filterStage.stop(stats.filter, stats.filterEvents);
+        stats.records += batch.records.size();
+    }
+
+    // Remove duplicates once everything is loaded, then report and hand out the stats
+    void finishLoad_(std::vector<Game*>& games, LoadStats& localStats, LoadStats* stats, GameGroups* groups) {
+        StageTimer_ dedupStage("load dedup");
+        localStats.duplicates = dedupGames(games, groups);
+        dedupStage.stop(localStats.dedup, localStats.dedupEvents);
+        localStats.kept = games.size();
+        fprintf(stderr, "number of games: %zu\n", games.size());
+        printLoadStats(localStats);
+        if (groups) {
+            fprintf(stderr, "%zu games in %zu groups\n", games.size(), groups->size());
+        }
+        if (stats) {
+            *stats = localStats;
+        }
+    }
+}
+
+std::vector<Game*> parseJsons(LoadStats* stats, GameGroups* groups) {
+    const trace::Span span("parse jsons");
+    const std::vector<std::string> blacklist = loadBlacklist_();
+    LoadStats localStats;
+    std::vector<Game*> games;
+    // Iterate through each file and create Game objects
+    const char* platformPath = "../games/platforms/jsons/";
+    const std::filesystem::directory_iterator directoryIterator(platformPath);
+    simdjson::ondemand::parser parser;
+    RecordBatch_ batch;
+
+    for (const auto& entry : directoryIterator) {
+        const trace::Span fileSpan("parse file", entry.path().filename().string());
+        const std::string platform = entry.path().filename().replace_extension().string();
+        if (entry.path().extension() == ".ndjson" || entry.path().extension() == ".jsonl") {
+            std::ifstream file(entry.path(), std::ios::binary);
+            parseNdjsonStream(file, platform, blacklist, games, localStats);
+            continue;
+        }
+        StageTimer_ readStage("load read");
+        auto json = simdjson::padded_string::load(entry.path().string());
+        readStage.stop(localStats.read, localStats.readEvents);
+        localStats.bytes += json.value_unsafe().size();
+
+        StageTimer_ parseStage("load parse");
+        batch.clear();
+        simdjson::ondemand::document document = parser.iterate(json);
+        for (auto game_json : document) {
+            extractRecord_(game_json.get_object(), batch);
+        }
+        parseStage.stop(localStats.parse, localStats.parseEvents);
+
+        addGames_(batch, platform, blacklist, games, localStats);
+    }
+    finishLoad_(games, localStats, stats, groups);
+    return games;
+}
+
+std::vector<Game*> parseNdjson(const std::string& path, LoadStats* stats, GameGroups* groups) {
+    const trace::Span span("parse ndjson", path);
+    const std::vector<std::string> blacklist = loadBlacklist_();
+    LoadStats localStats;
+    std::vector<Game*> games;
+    if (path == "-") {
+        parseNdjsonStream(std::cin, "stdin", blacklist, games, localStats);
+    } else {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open NDJSON file at " + path);
+        }
+        parseNdjsonStream(file, std::filesystem::path(path).filename().replace_extension().string(), blacklist,
+                          games, localStats);
+    }
+    finishLoad_(games, localStats, stats, groups);
+    return games;
+}
+
+void parseNdjsonStream(std::istream& input, const std::string& defaultPlatform,
+                       const std::vector<std::string>& blacklist, std::vector<Game*>& games, LoadStats& stats) {
+    // One window plus simdjson's padding, allocated once and reused for the whole stream
+    const std::unique_ptr<char[]> window(new char[NDJSON_WINDOW_SIZE + simdjson::SIMDJSON_PADDING]);
+    simdjson::ondemand::parser parser;
+    RecordBatch_ batch;
+    // Records from the previous window that weren't terminated by a newline yet
+    size_t carried = 0;
+    bool endOfInput = false;
+
+    while (!endOfInput) {
+        StageTimer_ readStage("load read");
+        input.read(window.get() + carried, static_cast<std::streamsize>(NDJSON_WINDOW_SIZE - carried));
+        const size_t filled = carried + static_cast<size_t>(input.gcount());
+        readStage.stop(stats.read, stats.readEvents);
+        stats.bytes += filled - carried;
+        endOfInput = !input;
+        if (filled == 0) {
+            break;
+        }
+
+        // Only hand complete lines to simdjson, unless this is the last window
+        size_t complete = filled;
+        if (!endOfInput) {
+            const size_t lastNewline = std::string_view(window.get(), filled).rfind('\n');
+            if (lastNewline == std::string_view::npos) {
+                throw std::runtime_error("NDJSON record larger than the " + std::to_string(NDJSON_WINDOW_SIZE) +
+                                         " byte read window");
+            }
+            complete = lastNewline + 1;
+        }
+        std::memset(window.get() + filled, 0, simdjson::SIMDJSON_PADDING);
+
+        StageTimer_ parseStage("load parse");
+        batch.clear();
+        // The batch size must hold the largest record, a whole window always does
+        simdjson::ondemand::document_stream stream = parser.iterate_many(window.get(), complete,
+                                                                         std::max<size_t>(complete, 64));
+        for (auto document : stream) {
+            extractRecord_(document.get_object(), batch);
+        }
+        parseStage.stop(stats.parse, stats.parseEvents);
+
+        addGames_(batch, defaultPlatform, blacklist, games, stats);
+
+        // Move the unterminated tail to the front of the window for the next read
+        carried = filled - complete;
+        std::memmove(window.get(), window.get() + complete, carried);
+    }
+}
+
+void printLoadStats(const LoadStats& stats) {
+    using millis = std::chrono::duration<double, std::milli>;
+    const double records = stats.records == 0 ? 1.0 : static_cast<double>(stats.records);
+    fprintf(stderr, "loaded %zu of %zu records (%zu bytes), %zu duplicates removed\n", stats.kept, stats.records,
+            stats.bytes, stats.duplicates);
+    fprintf(stderr, "  read   %8.2f ms\n  parse  %8.2f ms (%.1f ns/record)\n  build  %8.2f ms\n  filter %8.2f ms\n"
+            "  dedup  %8.2f ms\n",
+            millis(stats.read).count(), millis(stats.parse).count(),
+            static_cast<double>(stats.parse.count()) / records, millis(stats.build).count(),
+            millis(stats.filter).count(), millis(stats.dedup).count());
+
+    if (stats.parseEvents.available == 0) {
+        return;
+    }
+    const std::pair<const char*, const perf::CounterValues*> stages[] = {
+        {"read", &stats.readEvents}, {"parse", &stats.parseEvents}, {"build", &stats.buildEvents},
+        {"filter", &stats.filterEvents}, {"dedup", &stats.dedupEvents}};
+    fprintf(stderr, "  %-6s %6s %10s %10s %10s %10s  (misses per record)\n", "stage", "ipc", "l1d", "llc",
+            "branch", "dtlb");
+    for (const auto& [name, events] : stages) {
+        fprintf(stderr, "  %-6s %6.2f %10.2f %10.2f %10.2f %10.2f\n", name, events->ipc(),
+                static_cast<double>((*events)[perf::Event::L1dMisses]) / records,
+                static_cast<double>((*events)[perf::Event::LlcMisses]) / records,
+                static_cast<double>((*events)[perf::Event::BranchMisses]) / records,
+                static_cast<double>((*events)[perf::Event::DtlbMisses]) / records);
+    }
+}
+
+std::vector<std::string> getBlacklist() {
+    const char* path = "../config/blacklist.csv";
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::string msg = "Failed to find blacklist file at ";
+        msg.append(path);
+        throw std::ifstream::failure(msg);
+    }
+    std::vector<std::string> blacklist;
+    std::string word;
+    while (!file.eof()) {
+        std::getline(file, word, ',');
+        blacklist.push_back(word);
+    }
+    return blacklist;
+}
+
+// Ignore games that are possibly offensive
+bool isBlacklisted(const Game* game, const std::vector<std::string>& blacklist) {
+    std::string lowerTitle = game->get_title();
+    std::ranges::transform(lowerTitle.begin(), lowerTitle.end(), lowerTitle.begin(), tolower);
+    for (const unsigned char c : lowerTitle) {
+        // Remove games if they contain non-ascii or control characters
+        if (c < 32 || c >= 127) {
+            return true;
+        }
+    }
+
+    for (const auto& word : blacklist) {
+        if (game->get_title().find(word) != std::string::npos) {
+            return true;
+        }
+        std::vector<std::string> genres = game->get_genres();
+        if (std::ranges::find(genres.begin(), genres.end(), "Adult") != genres.end()) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <chrono>
+#include <istream>
+#include <string>
+#include <vector>
+
+#include "Game.hpp"
+#include "dedup.hpp"
+#include "perfcounters.hpp"
+
+/**
+ * @brief Time and volume spent in each stage of loading the games
+ *
+ * read: loading files or stream windows into memory
+ * parse: walking the JSON records and extracting their fields
+ * build: allocating the Game objects
+ * filter: checking games against the blacklist
+ * dedup: removing duplicate games and grouping them across platforms
+ *
+ * The *Events members hold the hardware counters of the same stages,
+ * see perfcounters.hpp. They are empty where counters are unavailable.
+ */
+struct LoadStats {
+    size_t bytes = 0;
+    size_t records = 0;
+    size_t duplicates = 0;
+    size_t kept = 0;
+    std::chrono::nanoseconds read{0};
+    std::chrono::nanoseconds parse{0};
+    std::chrono::nanoseconds build{0};
+    std::chrono::nanoseconds filter{0};
+    std::chrono::nanoseconds dedup{0};
+    perf::CounterValues readEvents;
+    perf::CounterValues parseEvents;
+    perf::CounterValues buildEvents;
+    perf::CounterValues filterEvents;
+    perf::CounterValues dedupEvents;
+};
+
+/**
+ * @brief Parse every platform file in games/platforms/jsons/ into Game objects
+ *
+ * .json files are expected to hold one array of games per platform.
+ * .ndjson and .jsonl files are streamed through parseNdjson() instead.
+ * The platform of each game is the file name without its extension.
+ * Blacklisted and duplicate games are dropped, see dedupGames().
+ *
+ * @param stats If not null, receives the time spent in each load stage
+ * @param groups If not null, receives the games grouped across platforms
+ */
+std::vector<Game*> parseJsons(LoadStats* stats = nullptr, GameGroups* groups = nullptr);
+
+/**
+ * @brief Stream newline-delimited JSON game records from a file
+ *
+ * @param path Path to an NDJSON file, or "-" to read from stdin
+ * @param stats If not null, receives the time spent in each load stage
+ * @param groups If not null, receives the games grouped across platforms
+ * @return The games that passed the blacklist, without duplicates
+ *
+ * Records may carry a "platform" string. Records without one are given
+ * the file name without its extension, or "stdin" when reading from stdin.
+ */
+std::vector<Game*> parseNdjson(const std::string& path, LoadStats* stats = nullptr, GameGroups* groups = nullptr);
+
+/**
+ * @brief Stream newline-delimited JSON game records into an existing vector
+ *
+ * @param input Any binary stream: a file, a pipe or stdin
+ * @param defaultPlatform Platform for records that don't name one
+ * @param blacklist Words that exclude a game, see isBlacklisted()
+ * @param games Vector that accepted games are appended to
+ * @param stats Load stage timings are added to this
+ *
+ * The stream is read in fixed-size windows that are cut at the last newline
+ * and handed to simdjson::ondemand::parser::iterate_many. The incomplete tail
+ * of a window is carried over to the next one, so memory use is bounded by
+ * the window size no matter how large the input is. A single record larger
+ * than the window is rejected with std::runtime_error.
+ */
+void parseNdjsonStream(std::istream& input, const std::string& defaultPlatform,
+                       const std::vector<std::string>& blacklist, std::vector<Game*>& games, LoadStats& stats);
+
+// Print the load stage timings and hardware counters of parseJsons or parseNdjson to stderr
+void printLoadStats(const LoadStats& stats);
+
+std::vector<std::string> getBlacklist();
+
+bool isBlacklisted(const Game* game, const std::vector<std::string>& blacklist);
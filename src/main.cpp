@@ -1,9 +1,10 @@
 #include <algorithm>
-#include <chrono>
 #include <iostream>
 #include <filesystem>
 #include <fstream>
+#include <optional>
 #include <random>
+#include <stdexcept>
 #include <string>
 
 // SFML graphics library
@@ -11,62 +12,168 @@
 
 // Objects that we wish to sort
 #include "Game.hpp"
-
-// Parse json files. Provided by https://github.com/simdjson/simdjson
-#include "../lib/simdjson.h"
-#include "timsort.hpp"
-#include "mergesort.hpp"
+#include "GameListView.hpp"
+
+#include "allocprofile.hpp"
+#include "compositesort.hpp"
+#include "footprint.hpp"
+#include "FrameScheduler.hpp"
+#include "genreindex.hpp"
+#include "instrument.hpp"
+#include "loader.hpp"
+#include "partialsort.hpp"
+#include "perfcounters.hpp"
+#include "sortjob.hpp"
+#include "sorts.hpp"
+#include "titleindex.hpp"
+#include "trace.hpp"
 #include "TextureManager.hpp"
 
-std::vector<Game*> renderLoadingWindow(const sf::Font& font);
+std::vector<Game*> renderLoadingWindow(const sf::Font& font, const std::string& ndjsonPath);
 
 sf::Text getLoadingWindowText(const sf::Font& font, const sf::RenderWindow& loadingWindow);
 
-std::vector<Game*> parseJsons();
-
-std::vector<std::string> getBlacklist();
-
-std::vector<std::string> getGenres(simdjson::simdjson_result<simdjson::ondemand::value> json);
-
-bool isBlacklisted(const Game* game, const std::vector<std::string>& blacklist);
-
-void renderMainWindow(const sf::Font& font, std::vector<Game*>& games);
-
-sf::Sprite getSprite(const sf::Texture& texture, float xPos, float yPos, float xScale, float yScale);
-
-std::array<sf::Text, 3> getThreeTitlesText(const sf::Font& font, const std::vector<Game*>& games, size_t index);
-
-std::array<sf::Text, 3> getThreeRatingsText(const sf::Font& font, const std::vector<Game*>& games, size_t index);
-
-std::array<sf::Text, 3> getThreeGenresText(const sf::Font& font, const std::vector<Game*>& games, size_t index);
-
-std::array<sf::Text, 3> getThreePlatsText(const sf::Font& font, const std::vector<Game*>& games, size_t index);
-
-void renderSortingWindow(const sf::Font& font, const std::string& sortedField, std::vector<Game*>& games);
-
-std::array<sf::Text, 5> getSortTimeTexts(const sf::Font& font, const sf::RenderWindow& sortingWindow,
-                                         std::vector<Game*>& games, bool (*comparator)(const Game*, const Game*));
+void renderMainWindow(const sf::Font& font, std::vector<Game*>& games, uint64_t seed,
+                      const std::vector<SortKey>& order);
+
+sf::Sprite getSprite(const TextureManager::Region& region, float xPos, float yPos, float xScale, float yScale);
+
+sf::VertexArray getSpriteBatch(const std::vector<const sf::Sprite*>& sprites);
+
+void appendUtf8(std::string& text, uint32_t codePoint);
+
+void popUtf8(std::string& text);
+
+void renderSortingWindow(const sf::Font& font, const std::string& sortedField, const std::vector<Game*>& input,
+                         std::vector<Game*>& games);
+
+// Names of SORT_ALGORITHMS as the sorting window shows them
+const std::array<const char*, 4> SORT_DISPLAY_NAMES = {
+    "Timsort", "Merge sort", "Binary insertion sort", "std::ranges::stable_sort"
+};
+
+// One algorithm's line in the sorting window while it sorts
+struct SortProgressRow {
+    sf::Text label;
+    sf::RectangleShape track;
+    sf::RectangleShape bar;
+    sf::Text cancelText;
+};
+
+std::array<SortProgressRow, 4> getSortProgressRows(const sf::Font& font);
+
+void updateSortProgressRows(std::array<SortProgressRow, 4>& rows, const SortJob& job);
+
+std::string getCountsLine(const instr::SortCounters& counters);
+
+std::string getEventsLine(const perf::CounterValues& events, size_t elements);
+
+std::array<sf::Text, 5> getSortTimeTexts(const sf::Font& font, const sf::RenderWindow& sortingWindow, SortJob& job,
+                                         std::vector<Game*>& games);
+
+int main(const int argc, char* argv[]) {
+    // --ndjson <path> streams newline-delimited records from a file instead of the platform jsons, "-" is stdin
+    // --seed <n> reproduces the starting shuffle of an earlier run
+    // --trace <path> writes a timeline of loading, sorting and rendering for chrome://tracing or Perfetto
+    // --memory prints the memory used by the games and their vectors after loading and while sorting
+    // --lazy-textures reads each image when it is first drawn instead of packing them all into an atlas
+    // --genres <query> only shows the games that match a genre query, e.g. "Action AND Shooter AND NOT Licensed"
+    // --order <fields> starts the main window in an order on several fields, e.g. "platform,-rating,title"
+    std::string ndjsonPath;
+    std::vector<SortKey> order;
+    std::string genreQuery;
+    std::optional<GenreQuery> parsedGenreQuery;
+    bool lazyTextures = false;
+    uint64_t seed = std::random_device{}();
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--ndjson" && i + 1 < argc) {
+            ndjsonPath = argv[++i];
+        } else if (std::string(argv[i]) == "--seed" && i + 1 < argc) {
+            seed = std::stoull(argv[++i]);
+        } else if (std::string(argv[i]) == "--memory") {
+            footprint::enableReports();
+        } else if (std::string(argv[i]) == "--genres" && i + 1 < argc) {
+            // Checked before loading, only unknown genres have to wait for the games
+            genreQuery = argv[++i];
+            try {
+                parsedGenreQuery.emplace(genreQuery);
+            } catch (const std::invalid_argument& error) {
+                std::cerr << "Invalid genre query: " << error.what() << '\n';
+                return 1;
+            }
+        } else if (std::string(argv[i]) == "--order" && i + 1 < argc) {
+            try {
+                order = parseSortKeys(argv[++i]);
+            } catch (const std::invalid_argument& error) {
+                std::cerr << "Invalid order: " << error.what() << '\n';
+                return 1;
+            }
+        } else if (std::string(argv[i]) == "--lazy-textures") {
+            lazyTextures = true;
+        } else if (std::string(argv[i]) == "--trace" && i + 1 < argc) {
+            try {
+                trace::start(argv[++i]);
+            } catch (const std::runtime_error& error) {
+                std::cerr << error.what() << '\n';
+                return 1;
+            }
+            // An exception escaping an atexit handler would call std::terminate
+            std::atexit([]() noexcept {
+                try {
+                    trace::finish();
+                } catch (const std::runtime_error& error) {
+                    std::cerr << error.what() << '\n';
+                }
+            });
+        }
+    }
+    std::cerr << "shuffle seed: " << seed << '\n';
+    if constexpr (heap::ENABLED) {
+        // The main window ends the program with std::exit, so the allocation report is printed on exit
+        std::atexit([] {
+            std::cerr << "allocations by phase:\n";
+            heap::printReport(std::cerr);
+        });
+    }
 
-int main() {
     sf::Font font;
     if (!font.loadFromFile("../res/font.ttf")) {
         throw (std::runtime_error("unable to load font, aborting!"));
     }
 
-    std::vector<Game*> games = renderLoadingWindow(font);
+    // The images are decoded and packed while the games load, the main window only uploads them
+    if (lazyTextures) {
+        TextureManager::getInstance("../res", TextureManager::LoadMode::Lazy);
+    } else {
+        TextureManager::preload("../res", sf::Texture::getMaximumSize());
+    }
+    std::vector<Game*> games = renderLoadingWindow(font, ndjsonPath);
+    if (parsedGenreQuery) {
+        const trace::Span filterSpan("genre filter", genreQuery);
+        const GenreIndex genreIndex(games);
+        try {
+            std::vector<Game*> matches = genreIndex.select(genreIndex.evaluate(*parsedGenreQuery));
+            std::cerr << "genre filter: " << matches.size() << " of " << games.size() << " games\n";
+            games = std::move(matches);
+        } catch (const std::invalid_argument& error) {
+            std::cerr << "Invalid genre query: " << error.what() << '\n';
+            return 1;
+        }
+    }
+    footprint::report("after loading", games, {&games});
 
-    renderMainWindow(font, games);
+    renderMainWindow(font, games, seed, order);
     return 0;
 }
 
-std::vector<Game*> renderLoadingWindow(const sf::Font& font) {
+std::vector<Game*> renderLoadingWindow(const sf::Font& font, const std::string& ndjsonPath) {
     sf::RenderWindow loadingWindow(sf::VideoMode(900, 450), "GameSort", sf::Style::Close);
     loadingWindow.setMouseCursorVisible(true);
     sf::Text text = getLoadingWindowText(font, loadingWindow);
     loadingWindow.clear(sf::Color(0, 33, 165));
     loadingWindow.draw(text);
     loadingWindow.display();
-    std::vector<Game*> games = parseJsons();
+    std::vector<Game*> games = ndjsonPath.empty() ? parseJsons() : parseNdjson(ndjsonPath);
     loadingWindow.close();
     return games;
 }
@@ -86,107 +193,18 @@ sf::Text getLoadingWindowText(const sf::Font& font, const sf::RenderWindow& load
     return text;
 }
 
-std::vector<Game*> parseJsons() {
-    std::vector<std::string> blacklist;
-    try {
-        blacklist = getBlacklist();
-    } catch (std::ifstream::failure& e) {
-        std::cerr << e.what() << "\nblacklist not functional, config/blacklist.csv not found.\n";
-    }
-    std::vector<Game*> games;
-    // Iterate through each file and create Game objects
-    const char* platformPath = "../games/platforms/jsons/";
-    const std::filesystem::directory_iterator directoryIterator(platformPath);
-    simdjson::ondemand::parser parser;
-
-    for (const auto& entry : directoryIterator) {
-        auto json = simdjson::padded_string::load(entry.path().string());
-        simdjson::ondemand::document document = parser.iterate(json);
-        for (auto game_json : document) {
-            std::string title;
-            if (game_json["title"].is_string()) {
-                std::string_view titleView = game_json["title"].get_string();
-                title = std::string(titleView);
-            }
-            const std::vector<std::string> genres = getGenres(game_json);
-            double score;
-            if (game_json["moby_score"].is_null()) {
-                score = 0.0F;
-            } else {
-                score = game_json["moby_score"].get_double();
-            }
-            const std::string platform = entry.path().filename().replace_extension().string();
-            auto game = new Game(title, genres, score, platform);
-            if (blacklist.empty() || !isBlacklisted(game, blacklist)) {
-                games.push_back(game);
-            }
-        }
-    }
-    printf("number of games: %llu\n", games.size());
-    return games;
-}
-
-std::vector<std::string> getBlacklist() {
-    const char* path = "../config/blacklist.csv";
-    std::ifstream file(path);
-    if (!file.is_open()) {
-        std::string msg = "Failed to find blacklist file at ";
-        msg.append(path);
-        throw std::ifstream::failure(msg);
-    }
-    std::vector<std::string> blacklist;
-    std::string word;
-    while (!file.eof()) {
-        std::getline(file, word, ',');
-        blacklist.push_back(word);
-    }
-    return blacklist;
-}
-
-std::vector<std::string> getGenres(simdjson::simdjson_result<simdjson::ondemand::value> json) {
-    std::vector<std::string> genres;
-    for (auto result : json["genres"]) {
-        // Need to make sure that genres is a string before emplacing to avoid simdjson error
-        if (result.is_string()) {
-            std::string_view genreView = result.get_string();
-            genres.emplace_back(genreView);
-        }
-    }
-    return genres;
-}
-
-// Ignore games that are possibly offensive
-bool isBlacklisted(const Game* game, const std::vector<std::string>& blacklist) {
-    std::string lowerTitle = game->get_title();
-    std::ranges::transform(lowerTitle.begin(), lowerTitle.end(), lowerTitle.begin(), tolower);
-    for (const unsigned char c : lowerTitle) {
-        // Remove games if they contain non-ascii or control characters
-        if (c < 32 || c >= 127) {
-            return true;
-        }
-    }
-
-    for (const auto& word : blacklist) {
-        if (game->get_title().find(word) != std::string::npos) {
-            return true;
-        }
-        std::vector<std::string> genres = game->get_genres();
-        if (std::ranges::find(genres.begin(), genres.end(), "Adult") != genres.end()) {
-            return true;
-        }
-    }
-    return false;
-}
-
-void renderMainWindow(const sf::Font& font, std::vector<Game*>& games) {
+void renderMainWindow(const sf::Font& font, std::vector<Game*>& games, const uint64_t seed,
+                      const std::vector<SortKey>& order) {
     // Shuffle the data to ensure a good spread to start
-    std::random_device rd;
-    std::mt19937 generator(rd());
+    std::mt19937_64 generator(seed);
     std::ranges::shuffle(games.begin(), games.end(), generator);
+    // Every sort starts from this shuffle rather than from the order the previous sort left behind,
+    // so that the timings of different runs can be compared
+    const std::vector<Game*> shuffledGames = games;
+    if (!order.empty()) {
+        compositeSort(games, order);
+    }
 
-    // Index of games vector that is currently being displayed
-    // ssize_t is okay, we only have 500,000ish games which can comfortably fit in a long
-    ssize_t gameIndex = 0;
 
     // Start up the main window
     sf::Color gatorOrange(250, 70, 22);
@@ -220,210 +238,302 @@ void renderMainWindow(const sf::Font& font, std::vector<Game*>& games) {
 
     // Point the singleton texture manager to the resource directory to get the textures and set the sprites
     TextureManager* textureManager = TextureManager::getInstance("../res");
-    sf::Sprite nextArrow = getSprite(textureManager->getTexture("arrowNext"), 1455, 650, 0.25, 0.25);
-    sf::Sprite prevArrow = getSprite(textureManager->getTexture("arrowPrevious"), 1355, 650, 0.25, 0.25);
-    sf::Sprite title = getSprite(textureManager->getTexture("titleButton"), 1400, 145, 0.13, 0.13);
-    sf::Sprite rating = getSprite(textureManager->getTexture("ratingButton"), 1400, 245, 0.13, 0.13);
-    sf::Sprite genre = getSprite(textureManager->getTexture("genreButton"), 1400, 345, 0.13, 0.13);
-    sf::Sprite platform = getSprite(textureManager->getTexture("platformButton"), 1400, 445, 0.13, 0.13);
-
-    // Event-based loop
+    sf::Sprite nextArrow = getSprite(textureManager->getRegion("arrowNext"), 1455, 650, 0.25, 0.25);
+    sf::Sprite prevArrow = getSprite(textureManager->getRegion("arrowPrevious"), 1355, 650, 0.25, 0.25);
+    sf::Sprite title = getSprite(textureManager->getRegion("titleButton"), 1400, 145, 0.13, 0.13);
+    sf::Sprite rating = getSprite(textureManager->getRegion("ratingButton"), 1400, 245, 0.13, 0.13);
+    sf::Sprite genre = getSprite(textureManager->getRegion("genreButton"), 1400, 345, 0.13, 0.13);
+    sf::Sprite platform = getSprite(textureManager->getRegion("platformButton"), 1400, 445, 0.13, 0.13);
+    // The buttons never move, so they are drawn from one vertex array with one texture bind if they share a page
+    const std::vector<const sf::Sprite*> buttons = {&title, &rating, &genre, &platform, &nextArrow, &prevArrow};
+    const bool buttonsBatched = std::ranges::all_of(buttons, [&](const sf::Sprite* button) {
+        return button->getTexture() == title.getTexture();
+    });
+    const sf::VertexArray buttonBatch = getSpriteBatch(buttons);
+
+    // The displayed games, left of the buttons and below the title
+    GameListView listView(font, games, sf::FloatRect(0.0F, 120.0F, 1250.0F, 580.0F));
+    sf::Clock animationClock;
+
+    // Typing a title jumps to the first displayed game that starts with it. Any other character than a digit
+    // starts a search, and clicking the search box starts an empty one. Enter or escape ends it.
+    TitleIndex titleIndex = [&] {
+        const trace::Span indexSpan("build title index");
+        return TitleIndex(games);
+    }();
+    // Set after a shift-click, until the search needs the whole order
+    std::optional<IncrementalSort> partialSort;
+    bool displayOrderStale = false;
+    std::string searchInput;
+    bool searching = false;
+    bool searchMatched = true;
+    sf::Text searchText;
+    searchText.setFont(font);
+    searchText.setCharacterSize(22);
+    searchText.setPosition(300.0F, 60.0F);
+
+    // Typing a number and pressing enter jumps to that rank
+    std::string rankInput;
+    sf::Text rankText;
+    rankText.setFont(font);
+    rankText.setCharacterSize(22);
+    rankText.setFillColor(sf::Color::White);
+    rankText.setPosition(1290.0F, 520.0F);
+    sf::Text positionText;
+    positionText.setFont(font);
+    positionText.setCharacterSize(22);
+    positionText.setFillColor(sf::Color::White);
+    positionText.setPosition(1290.0F, 565.0F);
+
+    // Event-driven loop, blocks while idle and only draws after something changed
+    FrameScheduler scheduler;
     while (mainWindow.isOpen()) {
         sf::Event event{};
-        std::array<sf::Text, 3> displayedGenres = getThreeGenresText(font, games, gameIndex);
-        std::array<sf::Text, 3> displayedPlatforms = getThreePlatsText(font, games, gameIndex);
-        std::array<sf::Text, 3> displayedRatings = getThreeRatingsText(font, games, gameIndex);
-        std::array<sf::Text, 3> displayedTitles = getThreeTitlesText(font, games, gameIndex);
-        while (mainWindow.pollEvent(event)) {
+        while (scheduler.nextEvent(mainWindow, event)) {
             if (event.type == sf::Event::Closed) {
                 // Click X on the window
                 games.clear();
                 mainWindow.close();
                 std::exit(0);
             }
+            if (listView.handleEvent(event, mainWindow)) {
+                scheduler.requestRedraw();
+            }
+            if (event.type == sf::Event::TextEntered) {
+                const uint32_t unicode = event.text.unicode;
+                const bool digit = unicode >= '0' && unicode <= '9';
+                const bool printable = unicode >= ' ' && unicode != 127;
+                if (searching || (rankInput.empty() && !digit && printable && unicode != ' ')) {
+                    searching = true;
+                    if (unicode == '\b') {
+                        popUtf8(searchInput);
+                    } else if (printable && searchInput.size() < 100) {
+                        appendUtf8(searchInput, unicode);
+                    }
+                    if (partialSort && !partialSort->done()) {
+                        // A match can be anywhere in the order, so the search needs all of it
+                        partialSort->sortPrefix(games.size());
+                    }
+                    if (displayOrderStale) {
+                        titleIndex.setDisplayOrder(games);
+                        displayOrderStale = false;
+                    }
+                    const std::optional<size_t> match = titleIndex.findFirstDisplayed(searchInput);
+                    searchMatched = match.has_value();
+                    if (match && !searchInput.empty()) {
+                        listView.scrollToRow(*match, true);
+                    }
+                } else if (digit && rankInput.size() < 12) {
+                    rankInput += static_cast<char>(unicode);
+                } else if (unicode == '\b' && !rankInput.empty()) {
+                    rankInput.pop_back();
+                }
+                scheduler.requestRedraw();
+            }
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Enter && searching) {
+                // The view already shows the match
+                searching = false;
+                searchInput.clear();
+                searchMatched = true;
+                scheduler.requestRedraw();
+            } else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Enter &&
+                       !rankInput.empty()) {
+                // Ranks start at 1, scrollToRow clamps past the end
+                const size_t rank = std::stoull(rankInput);
+                listView.scrollToRow(rank == 0 ? 0 : rank - 1, true);
+                rankInput.clear();
+                scheduler.requestRedraw();
+            }
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) {
+                rankInput.clear();
+                searching = false;
+                searchInput.clear();
+                searchMatched = true;
+                scheduler.requestRedraw();
+            }
             // If left mouse button pressed, check what was clicked
             if (event.type == sf::Event::MouseButtonPressed && mainWindow.hasFocus()) {
+                // Paging and sorting both change the rows, and the sorting window covered this one
+                scheduler.requestRedraw();
                 sf::Vector2i mouse = sf::Mouse::getPosition(mainWindow);
                 if (nextArrow.getGlobalBounds().contains(mainWindow.mapPixelToCoords(mouse))) {
-                    if (gameIndex + 3 < static_cast<ssize_t>(games.size())) {
-                        gameIndex += 3;
-                    }
+                    listView.scrollPages(1);
                 }
                 if (prevArrow.getGlobalBounds().contains(mainWindow.mapPixelToCoords(mouse))) {
-                    if (gameIndex - 3 >= 0) {
-                        gameIndex -= 3;
-                    }
+                    listView.scrollPages(-1);
+                }
+                if (searchText.getGlobalBounds().contains(mainWindow.mapPixelToCoords(mouse))) {
+                    searching = true;
+                    rankInput.clear();
                 }
                 std::string sortedField;
                 if (title.getGlobalBounds().contains(mainWindow.mapPixelToCoords(mouse))) {
                     sortedField = "title";
-                    renderSortingWindow(font, sortedField, games);
                 }
                 if (rating.getGlobalBounds().contains(mainWindow.mapPixelToCoords(mouse))) {
                     sortedField = "rating";
-                    renderSortingWindow(font, sortedField, games);
                 }
                 if (genre.getGlobalBounds().contains(mainWindow.mapPixelToCoords(mouse))) {
                     sortedField = "genre";
-                    renderSortingWindow(font, sortedField, games);
                 }
                 if (platform.getGlobalBounds().contains(mainWindow.mapPixelToCoords(mouse))) {
                     sortedField = "platform";
-                    renderSortingWindow(font, sortedField, games);
+                }
+                const bool shift = sf::Keyboard::isKeyPressed(sf::Keyboard::LShift) ||
+                                   sf::Keyboard::isKeyPressed(sf::Keyboard::RShift);
+                if (!sortedField.empty() && shift) {
+                    // Shift-click orders the list without timing the sorts, rows are sorted as they come into view
+                    const auto comparator = std::ranges::find_if(SORT_COMPARATORS,
+                                                                 [&](const SortComparator& candidate) {
+                        return sortedField == candidate.name;
+                    });
+                    games = shuffledGames;
+                    partialSort.emplace(games, comparator->compare);
+                    displayOrderStale = true;
+                    listView.invalidate();
+                } else if (!sortedField.empty()) {
+                    // Closing the sorting window early keeps the games as they are, so the order on screen is
+                    // finished first instead of leaving a sorted prefix in front of unsorted games
+                    if (partialSort && !partialSort->done()) {
+                        partialSort->sortPrefix(games.size());
+                    }
+                    partialSort.reset();
+                    renderSortingWindow(font, sortedField, shuffledGames, games);
+                    listView.invalidate();
+                    titleIndex.setDisplayOrder(games);
+                    displayOrderStale = false;
                 }
             }
         }
-        mainWindow.clear(gatorOrange);
-        mainWindow.draw(title);
-        mainWindow.draw(rating);
-        mainWindow.draw(genre);
-        mainWindow.draw(platform);
-        mainWindow.draw(nextArrow);
-        mainWindow.draw(prevArrow);
-        mainWindow.draw(welcomeText);
-        mainWindow.draw(sortGamesText);
-        for (const auto& genreText : displayedGenres) {
-            mainWindow.draw(genreText);
-        }
-        for (const auto& platformText : displayedPlatforms) {
-            mainWindow.draw(platformText);
+        if (!scheduler.frameDue()) {
+            continue;
         }
-        for (const auto& scoreText : displayedRatings) {
-            mainWindow.draw(scoreText);
+        const trace::Span frameSpan("frame");
+        const heap::Phase framePhase("render frame");
+        scheduler.setAnimating(listView.animate(animationClock.restart()));
+        if (partialSort && !partialSort->done()) {
+            // The rows on screen and the page below them, so that paging down never waits for a partition
+            partialSort->sortPrefix(listView.getFirstRow() + 2 * listView.getVisibleRowCount());
         }
-        for (const auto& titleText : displayedTitles) {
-            mainWindow.draw(titleText);
+        listView.update();
+        const std::string search = "Search titles: " + searchInput + (searching ? "_" : "");
+        searchText.setString(sf::String::fromUtf8(search.begin(), search.end()));
+        searchText.setFillColor(searchMatched ? sf::Color::White : sf::Color(255, 210, 210));
+        rankText.setString("Go to rank: " + rankInput + "_");
+        positionText.setString(std::to_string(std::min(listView.getFirstRow() + 1, games.size())) + " - " +
+                               std::to_string(listView.getFirstRow() + listView.getVisibleRowCount()) + " of " +
+                               std::to_string(games.size()));
+        mainWindow.clear(gatorOrange);
+        if (buttonsBatched) {
+            mainWindow.draw(buttonBatch, sf::RenderStates(title.getTexture()));
+        } else {
+            for (const sf::Sprite* button : buttons) {
+                mainWindow.draw(*button);
+            }
         }
+        mainWindow.draw(welcomeText);
+        mainWindow.draw(sortGamesText);
+        mainWindow.draw(listView);
+        mainWindow.draw(searchText);
+        mainWindow.draw(rankText);
+        mainWindow.draw(positionText);
         mainWindow.display();
-        // Lock framerate to 60 to avoid high CPU consumption
-        sf::sleep(sf::seconds(1.0F / 60.0F));
+        scheduler.frameDrawn();
     }
 }
 
 
-sf::Sprite getSprite(const sf::Texture& texture, const float xPos, float const yPos,
+sf::Sprite getSprite(const TextureManager::Region& region, const float xPos, float const yPos,
                      float const xScale, float const yScale) {
-    sf::Sprite sprite;
-    sprite.setTexture(texture);
+    sf::Sprite sprite(*region.texture, region.rect);
     // Scale the sprite so that it fits nicely on the screen and set its position
     sprite.setScale(xScale, yScale);
-    sprite.setOrigin(static_cast<float>(texture.getSize().x) / 2.0F, static_cast<float>(texture.getSize().y) / 2.0F);
+    sprite.setOrigin(static_cast<float>(region.rect.width) / 2.0F, static_cast<float>(region.rect.height) / 2.0F);
     sprite.setPosition(xPos, yPos);
     return sprite;
 }
 
-std::array<sf::Text, 3> getThreeTitlesText(const sf::Font& font, const std::vector<Game*>& games, const size_t index) {
-    constexpr size_t MAX_TITLE_LENGTH = 100;
-    std::array<sf::Text, 3> displayedTitles;
-    for (size_t i = 0; i < displayedTitles.size(); ++i) {
-        std::string title = games[index + i]->get_title();
-        if (title.size() >= MAX_TITLE_LENGTH) {
-            title = title.substr(0, 97) + "...";
-        }
-        for (size_t stringIndex = 24; stringIndex < title.size(); stringIndex += 25) {
-            title.insert(stringIndex, "-\n");
-        }
-        displayedTitles[i].setString(title);
-        displayedTitles[i].setFont(font);
-        displayedTitles[i].setCharacterSize(25);
-        displayedTitles[i].setFillColor(sf::Color::White);
-        // Casting is fine, i is always less than 3
-        displayedTitles[i].setPosition(50, 145.0F + 175.0F * static_cast<float>(i));
+// Encode a code point of a TextEntered event into UTF-8, the encoding of the titles
+void appendUtf8(std::string& text, const uint32_t codePoint) {
+    if (codePoint < 0x80) {
+        text += static_cast<char>(codePoint);
+    } else if (codePoint < 0x800) {
+        text += static_cast<char>(0xC0 | (codePoint >> 6));
+        text += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else if (codePoint < 0x10000) {
+        text += static_cast<char>(0xE0 | (codePoint >> 12));
+        text += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        text += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else {
+        text += static_cast<char>(0xF0 | (codePoint >> 18));
+        text += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+        text += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        text += static_cast<char>(0x80 | (codePoint & 0x3F));
     }
-    return displayedTitles;
 }
 
-std::array<sf::Text, 3> getThreeRatingsText(const sf::Font& font, const std::vector<Game*>& games, const size_t index) {
-    std::array<sf::Text, 3> displayedRatings;
-    for (size_t i = 0; i < displayedRatings.size(); ++i) {
-        displayedRatings[i].setString(std::format("{:.2f}", games[index + i]->get_score()) + " / 10");
-        displayedRatings[i].setFont(font);
-        displayedRatings[i].setCharacterSize(25);
-        displayedRatings[i].setFillColor(sf::Color::White);
-        // Casting is fine, i is always less than 3
-        displayedRatings[i].setPosition(475.0F, 145.0F + 175.0F * static_cast<float>(i));
+// Remove the last character, with all of its UTF-8 continuation bytes
+void popUtf8(std::string& text) {
+    while (!text.empty() && (static_cast<unsigned char>(text.back()) & 0xC0) == 0x80) {
+        text.pop_back();
+    }
+    if (!text.empty()) {
+        text.pop_back();
     }
-    return displayedRatings;
 }
 
-std::array<sf::Text, 3> getThreeGenresText(const sf::Font& font, const std::vector<Game*>& games, const size_t index) {
-    std::array<sf::Text, 3> displayedGenres;
-    for (size_t i = 0; i < displayedGenres.size(); ++i) {
-        auto genres = games[index + i]->get_genres();
-        std::string genreString;
-        for (size_t genreIndex = 0; (genreIndex < genres.size() && genreIndex <= 4); ++genreIndex) {
-            if (genres[genreIndex].length() <= 20) {
-                genreString += genres[genreIndex] + '\n';
-                continue;
-            }
-            genreString += genres[genreIndex].substr(0, 17) + "...\n";
+// Two triangles per sprite, with each sprite's transform applied, to draw with their shared texture
+sf::VertexArray getSpriteBatch(const std::vector<const sf::Sprite*>& sprites) {
+    sf::VertexArray vertices(sf::Triangles);
+    for (const sf::Sprite* sprite : sprites) {
+        const sf::IntRect rect = sprite->getTextureRect();
+        const auto width = static_cast<float>(rect.width);
+        const auto height = static_cast<float>(rect.height);
+        const auto left = static_cast<float>(rect.left);
+        const auto top = static_cast<float>(rect.top);
+        const sf::Transform& transform = sprite->getTransform();
+        const std::array<sf::Vertex, 4> corners = {
+            sf::Vertex(transform.transformPoint(sf::Vector2f(0.0F, 0.0F)), sf::Vector2f(left, top)),
+            sf::Vertex(transform.transformPoint(sf::Vector2f(width, 0.0F)), sf::Vector2f(left + width, top)),
+            sf::Vertex(transform.transformPoint(sf::Vector2f(0.0F, height)), sf::Vector2f(left, top + height)),
+            sf::Vertex(transform.transformPoint(sf::Vector2f(width, height)),
+                       sf::Vector2f(left + width, top + height)),
+        };
+        for (const size_t corner : {0, 1, 2, 2, 1, 3}) {
+            vertices.append(corners[corner]);
         }
-        displayedGenres[i].setString(genreString);
-        displayedGenres[i].setFont(font);
-        displayedGenres[i].setCharacterSize(25);
-        displayedGenres[i].setFillColor(sf::Color::White);
-        // Casting is fine, i is always less than 3
-        displayedGenres[i].setPosition(950.0F, 145.0F + 175.0F * static_cast<float>(i));
     }
-    return displayedGenres;
+    return vertices;
 }
 
-std::array<sf::Text, 3> getThreePlatsText(const sf::Font& font, const std::vector<Game*>& games, const size_t index) {
-    std::array<sf::Text, 3> displayedPlatforms;
-    for (size_t i = 0; i < displayedPlatforms.size(); ++i) {
-        if (std::string platformString = games[index + i]->get_platform(); platformString.size() <= 20) {
-            displayedPlatforms[i].setString(platformString);
-        } else {
-            displayedPlatforms[i].setString(platformString.substr(0, 17) + "...");
+std::array<sf::Text, 5> getSortTimeTexts(const sf::Font& font, const sf::RenderWindow& sortingWindow, SortJob& job,
+                                         std::vector<Game*>& games) {
+    std::array<sf::Text, 5> sortTexts;
+    std::vector<const std::vector<Game*>*> vectors = {&games, &job.input()};
+    std::vector<Game*>* displayed = nullptr;
+    for (size_t i = 0; i < job.size(); ++i) {
+        const SortRun& run = job.run(i);
+        if (!run.finished) {
+            sortTexts[i].setString(std::string(SORT_DISPLAY_NAMES[i]) + " was cancelled");
+            continue;
+        }
+        sortTexts[i].setString(std::string(SORT_DISPLAY_NAMES[i]) + " took " + std::to_string(run.milliseconds) +
+                               " milliseconds" + getCountsLine(run.counts) +
+                               getEventsLine(run.events, job.input().size()));
+        vectors.push_back(&job.result(i));
+        if (displayed == nullptr) {
+            displayed = &job.result(i);
         }
-        displayedPlatforms[i].setFont(font);
-        displayedPlatforms[i].setCharacterSize(25);
-        displayedPlatforms[i].setFillColor(sf::Color::White);
-        // Casting is fine, i is always less than 3
-        displayedPlatforms[i].setPosition(650.0F, 145.0F + 175.0F * static_cast<float>(i));
     }
-    return displayedPlatforms;
-}
 
-std::array<sf::Text, 5> getSortTimeTexts(const sf::Font& font, const sf::RenderWindow& sortingWindow,
-                                         std::vector<Game*>& games, bool (*comparator)(const Game*, const Game*)) {
-    using std::chrono::duration_cast;
-    using millis = std::chrono::milliseconds;
-    using clock = std::chrono::high_resolution_clock;
-
-    std::vector<Game*> mergeSortGames = games, binaryInsertionSortGames = games, stableSortGames = games;
-
-    // TIM SORT 
-    auto timeStart = clock::now();
-    ts::timsort(games, comparator);
-    const long long timsortTime = (duration_cast<millis>(clock::now() - timeStart)).count();
-    sf::Text timsortText;
-    timsortText.setString("Timsort took " + std::to_string(timsortTime) + " milliseconds");
-
-    // MERGE SORT 
-    timeStart = clock::now();
-    ms::mergeSort(mergeSortGames, comparator);
-    const long long mergeSortTime = (duration_cast<millis>(clock::now() - timeStart)).count();
-    sf::Text mergeSortText;
-    mergeSortText.setString("Merge sort took " + std::to_string(mergeSortTime) + " milliseconds");
-
-    // BINARY INSERTION SORT
-    timeStart = clock::now();
-    ts::binaryInsertionSort(binaryInsertionSortGames, comparator);
-    const long long binaryInsertionSortTime = (duration_cast<millis>(clock::now() - timeStart)).count();
-    sf::Text binaryInsertionSortText;
-    binaryInsertionSortText.setString(
-        "Binary insertion sort took " + std::to_string(binaryInsertionSortTime) + " milliseconds");
-
-    // STABLE_SORT
-    timeStart = clock::now();
-    std::ranges::stable_sort(stableSortGames.begin(), stableSortGames.end(), comparator);
-    const long long stableSortTime = (duration_cast<millis>(clock::now() - timeStart)).count();
-    sf::Text stableSortText;
-    stableSortText.setString("std::ranges::stable_sort took " + std::to_string(stableSortTime) + " milliseconds");
+    footprint::report("while sorting", games, vectors);
+
+    // Display the result of the first sort that finished, timsort unless it was cancelled
+    if (displayed != nullptr) {
+        games = std::move(*displayed);
+    }
 
     // Deliberately avoiding the last element, it will be overwritten by the title anyway
-    std::array<sf::Text, 5> sortTexts = {timsortText, mergeSortText, binaryInsertionSortText, stableSortText};
     // Set up the text attributes for the array
     for (size_t i = 0; i < sortTexts.size(); ++i) {
         sortTexts[i].setFont(font);
@@ -437,69 +547,162 @@ std::array<sf::Text, 5> getSortTimeTexts(const sf::Font& font, const sf::RenderW
     return sortTexts;
 }
 
-void renderSortingWindow(const sf::Font& font, const std::string& sortedField, std::vector<Game*>& games) {
+std::array<SortProgressRow, 4> getSortProgressRows(const sf::Font& font) {
+    std::array<SortProgressRow, 4> rows;
+    for (size_t i = 0; i < rows.size(); ++i) {
+        // Casting is fine, i is always less than 4
+        const float y = 180.0F + 100.0F * static_cast<float>(i);
+        rows[i].label.setFont(font);
+        rows[i].label.setCharacterSize(28);
+        rows[i].label.setFillColor(sf::Color::White);
+        rows[i].label.setPosition(100.0F, y);
+
+        rows[i].track.setSize(sf::Vector2f(560.0F, 12.0F));
+        rows[i].track.setPosition(100.0F, y + 45.0F);
+        rows[i].track.setFillColor(sf::Color(255, 255, 255, 60));
+        rows[i].bar.setPosition(100.0F, y + 45.0F);
+        rows[i].bar.setFillColor(sf::Color(250, 70, 22));
+
+        rows[i].cancelText.setString("Cancel");
+        rows[i].cancelText.setFont(font);
+        rows[i].cancelText.setCharacterSize(25);
+        rows[i].cancelText.setStyle(sf::Text::Underlined);
+        rows[i].cancelText.setFillColor(sf::Color::White);
+        rows[i].cancelText.setPosition(700.0F, y + 25.0F);
+    }
+    return rows;
+}
+
+void updateSortProgressRows(std::array<SortProgressRow, 4>& rows, const SortJob& job) {
+    for (size_t i = 0; i < rows.size(); ++i) {
+        const progress::SortProgress& sortProgress = job.progress(i);
+        std::string state;
+        if (sortProgress.cancelled()) {
+            state = "cancelled";
+        } else if (sortProgress.done() == 0) {
+            state = "waiting";
+        } else {
+            state = std::to_string(static_cast<int>(sortProgress.fraction() * 100.0)) + " %";
+        }
+        rows[i].label.setString(std::string(SORT_DISPLAY_NAMES[i]) + ": " + state);
+        rows[i].bar.setSize(sf::Vector2f(560.0F * static_cast<float>(sortProgress.fraction()), 12.0F));
+    }
+}
+
+void renderSortingWindow(const sf::Font& font, const std::string& sortedField, const std::vector<Game*>& input,
+                         std::vector<Game*>& games) {
     sf::RenderWindow sortingWindow(sf::VideoMode(900, 600), "GameSort", sf::Style::Close);
     sf::Color gatorBlue(0, 33, 165);
     sortingWindow.setMouseCursorVisible(true);
     sortingWindow.setKeyRepeatEnabled(true);
-    sf::Text sortingText;
-    sortingText.setString("Sorting by " + sortedField + "...");
-    sortingText.setFont(font);
-    sortingText.setCharacterSize(50);
-    sortingText.setStyle(sf::Text::Bold | sf::Text::Italic);
-    sortingText.setFillColor(sf::Color::White);
-
-    const sf::FloatRect sortingTextRect = sortingText.getLocalBounds();
-    sortingText.setOrigin(sortingTextRect.left + sortingTextRect.width / 2.0F,
-                          sortingTextRect.top + sortingTextRect.height / 2.0F);
-    sortingText.setPosition(static_cast<float>(sortingWindow.getSize().x) / 2.0F,
-                            static_cast<float>(sortingWindow.getSize().y) / 2.0F);
-    sortingWindow.clear(gatorBlue);
-    sortingWindow.draw(sortingText);
-    sortingWindow.display();
-
-    // To keep the timing fair, pass a different vector to each sort
-    // Timsort gets the original vector for no particular reason
-    std::vector<Game*> mergeSortGames = games, binaryInsertionSortGames = games, stableSortGames = games;
-    std::array<sf::Text, 5> sortingWindowTexts;
-    if (sortedField == "title") {
-        sortingWindowTexts = getSortTimeTexts(font, sortingWindow, games, Game::compareTitles);
-    } else if (sortedField == "rating") {
-        sortingWindowTexts = getSortTimeTexts(font, sortingWindow, games, Game::compareScores);
-    } else if (sortedField == "genre") {
-        sortingWindowTexts = getSortTimeTexts(font, sortingWindow, games, Game::compareGenres);
-    } else {
-        sortingWindowTexts = getSortTimeTexts(font, sortingWindow, games, Game::comparePlatform);
+
+    // The sorts run on a worker thread, this one keeps drawing their progress and handling clicks
+    const auto comparator = std::ranges::find_if(SORT_COMPARATORS, [&](const SortComparator& candidate) {
+        return sortedField == candidate.name;
+    });
+    std::vector<const SortAlgorithm*> algorithms;
+    for (const auto& algorithm : SORT_ALGORITHMS) {
+        algorithms.push_back(&algorithm);
     }
+    SortJob job(input, comparator->compare, algorithms);
+    std::array<SortProgressRow, 4> progressRows = getSortProgressRows(font);
 
     sf::Text headerText;
-    headerText.setString("Sort completed! Stats:");
+    headerText.setString("Sorting by " + sortedField + "...");
     headerText.setFont(font);
     headerText.setCharacterSize(50);
-    headerText.setStyle(sf::Text::Bold);
+    headerText.setStyle(sf::Text::Bold | sf::Text::Italic);
     headerText.setFillColor(sf::Color::White);
-    const sf::FloatRect headerTextRect = headerText.getLocalBounds();
+    sf::FloatRect headerTextRect = headerText.getLocalBounds();
     headerText.setOrigin(headerTextRect.left + headerTextRect.width / 2.0F,
                          headerTextRect.top + headerTextRect.height / 2.0F);
     headerText.setPosition(static_cast<float>(sortingWindow.getSize().x) / 2.0F, 100.0F);
-    sortingWindowTexts[4] = headerText;
 
+    std::array<sf::Text, 5> sortingWindowTexts;
+    bool finished = false;
+    // Animates while the sorts run, once the results are up it only wakes up for window events
+    FrameScheduler scheduler;
+    scheduler.setAnimating(true);
     while (sortingWindow.isOpen()) {
         sf::Event event{};
-        while (sortingWindow.pollEvent(event)) {
+        while (scheduler.nextEvent(sortingWindow, event)) {
             if (event.type == sf::Event::Closed) {
+                // Leaves the games as they were, the job cancels what is left and waits for its worker
                 sortingWindow.close();
                 return;
             }
             if (event.type == sf::Event::LostFocus) {
                 sortingWindow.requestFocus();
             }
+            if (event.type == sf::Event::MouseButtonPressed && !finished) {
+                const sf::Vector2f mouse = sortingWindow.mapPixelToCoords(
+                    sf::Vector2i(event.mouseButton.x, event.mouseButton.y));
+                for (size_t i = 0; i < progressRows.size(); ++i) {
+                    if (progressRows[i].cancelText.getGlobalBounds().contains(mouse) &&
+                        job.progress(i).fraction() < 1.0) {
+                        job.cancel(i);
+                    }
+                }
+            }
         }
+
+        if (!finished && job.done()) {
+            finished = true;
+            sortingWindowTexts = getSortTimeTexts(font, sortingWindow, job, games);
+            headerText.setString("Sort completed! Stats:");
+            headerText.setStyle(sf::Text::Bold);
+            headerTextRect = headerText.getLocalBounds();
+            headerText.setOrigin(headerTextRect.left + headerTextRect.width / 2.0F,
+                                 headerTextRect.top + headerTextRect.height / 2.0F);
+            sortingWindowTexts[4] = headerText;
+            scheduler.setAnimating(false);
+        }
+
+        if (!scheduler.frameDue()) {
+            continue;
+        }
+        const trace::Span frameSpan("frame");
+        const heap::Phase framePhase("render frame");
         sortingWindow.clear(gatorBlue);
-        for (const auto& text : sortingWindowTexts) {
-            sortingWindow.draw(text);
+        if (finished) {
+            for (const auto& text : sortingWindowTexts) {
+                sortingWindow.draw(text);
+            }
+        } else {
+            updateSortProgressRows(progressRows, job);
+            sortingWindow.draw(headerText);
+            for (size_t i = 0; i < progressRows.size(); ++i) {
+                sortingWindow.draw(progressRows[i].label);
+                sortingWindow.draw(progressRows[i].track);
+                sortingWindow.draw(progressRows[i].bar);
+                // Nothing left to cancel once a sort is done or cancelled
+                if (!job.progress(i).cancelled() && job.progress(i).fraction() < 1.0) {
+                    sortingWindow.draw(progressRows[i].cancelText);
+                }
+            }
         }
         sortingWindow.display();
-        sf::sleep(sf::seconds(1.0F / 60.0F));
+        scheduler.frameDrawn();
+    }
+}
+
+// Instrumented builds show what each sort did under its time, see instrument.hpp
+std::string getCountsLine(const instr::SortCounters& counters) {
+    if constexpr (!instr::ENABLED) {
+        return "";
+    }
+    return "\n" + std::to_string(counters.comparisons) + " comparisons, " + std::to_string(counters.moves) +
+           " moves, " + std::to_string(counters.allocations) + " allocations";
+}
+
+// Where hardware counters are available, show whether a sort waited on memory under its time
+std::string getEventsLine(const perf::CounterValues& events, const size_t elements) {
+    if (events.available == 0 || elements == 0) {
+        return "";
     }
+    const auto perGame = [&](const perf::Event event) {
+        return std::format("{:.2f}", static_cast<double>(events[event]) / static_cast<double>(elements));
+    };
+    return std::format("\nIPC {:.2f}, {} LLC and {} branch misses per game", events.ipc(),
+                       perGame(perf::Event::LlcMisses), perGame(perf::Event::BranchMisses));
 }
@@ -2,8 +2,15 @@
 
 #include <iostream>
 
+#include "instrument.hpp"
+#include "sortprogress.hpp"
+
 namespace ms {
     void mergeSort(std::vector<Game*>& games, bool (*comparator)(const Game* lhs, const Game* rhs)) {
+        // nothing to sort, and games.size() - 1 would wrap around for an empty vector
+        if (games.size() < 2) {
+            return;
+        }
         // call recursive merge sort w/ entire game range
         recursiveMergeSort_(games, 0, games.size() - 1, comparator);
     }
@@ -40,6 +47,9 @@ namespace ms {
             rightGames[j] = games[mid + 1 + j];
         }
 
+        // every element is copied to a temp array and written back once
+        instr::countMoves(2 * (sizeLeft + sizeRight));
+
         // initial idx of left + right arrays
         size_t i = 0;
         size_t j = 0;
@@ -49,10 +59,11 @@ namespace ms {
 
         // merge temp arrays back in the original array
         while (i < sizeLeft && j < sizeRight) {
-            if (comparator(leftGames[i], rightGames[j])) {
-                games[k++] = leftGames[i++];
-            } else {
+            // take from the right only if it is strictly smaller, so equal games keep their order (stability)
+            if (comparator(rightGames[j], leftGames[i])) {
                 games[k++] = rightGames[j++];
+            } else {
+                games[k++] = leftGames[i++];
             }
         }
 
@@ -65,5 +76,8 @@ namespace ms {
         while (j < sizeRight) {
             games[k++] = rightGames[j++];
         }
+
+        // Progress is counted in elements merged, see SortAlgorithm::work
+        progress::advance(sizeLeft + sizeRight);
     }
 }
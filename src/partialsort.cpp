@@ -0,0 +1,126 @@
+#include "partialsort.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+#include "trace.hpp"
+
+IncrementalSort::IncrementalSort(std::vector<Game*>& games, const GameComparator comparator) :
+    games_(games), comparator_(comparator), positions_(games.size()), pivots_{games.size()} {
+    if (games.size() > std::numeric_limits<uint32_t>::max()) {
+        throw std::invalid_argument("IncrementalSort sorts at most 2^32 games");
+    }
+    std::iota(positions_.begin(), positions_.end(), 0U);
+}
+
+void IncrementalSort::sortPrefix(size_t count) {
+    count = std::min(count, games_.size());
+    if (sorted_ >= count) {
+        return;
+    }
+    const trace::Span span("partial sort", std::to_string(count));
+    while (sorted_ < count) {
+        const size_t pivot = pivots_.back();
+        if (pivot == sorted_) {
+            // Everything before it is sorted, so the pivot is the next game
+            pivots_.pop_back();
+            ++sorted_;
+        } else if (pivot - sorted_ <= INSERTION_LIMIT_) {
+            insertionSort_(sorted_, pivot);
+            sorted_ = pivot;
+        } else {
+            pivots_.push_back(partition_(sorted_, pivot));
+        }
+    }
+}
+
+size_t IncrementalSort::getSortedCount() const {
+    return sorted_;
+}
+
+bool IncrementalSort::done() const {
+    return sorted_ == games_.size();
+}
+
+bool IncrementalSort::less_(const size_t lhs, const size_t rhs) const {
+    if (comparator_(games_[lhs], games_[rhs])) {
+        return true;
+    }
+    return !comparator_(games_[rhs], games_[lhs]) && positions_[lhs] < positions_[rhs];
+}
+
+void IncrementalSort::swap_(const size_t lhs, const size_t rhs) {
+    std::swap(games_[lhs], games_[rhs]);
+    std::swap(positions_[lhs], positions_[rhs]);
+}
+
+size_t IncrementalSort::partition_(const size_t first, const size_t last) {
+    // Median of three into the last slot, so sorted and reversed inputs still split in half
+    const size_t middle = first + (last - first) / 2;
+    const size_t back = last - 1;
+    if (less_(middle, first)) {
+        swap_(middle, first);
+    }
+    if (less_(back, first)) {
+        swap_(back, first);
+    }
+    if (less_(middle, back)) {
+        swap_(middle, back);
+    }
+    // The order with positions as the tie-breaker is total, so no two games are equal to the pivot
+    size_t store = first;
+    for (size_t i = first; i < back; ++i) {
+        if (less_(i, back)) {
+            swap_(i, store++);
+        }
+    }
+    swap_(store, back);
+    return store;
+}
+
+void IncrementalSort::insertionSort_(const size_t first, const size_t last) {
+    for (size_t i = first + 1; i < last; ++i) {
+        for (size_t j = i; j > first && less_(j, j - 1); --j) {
+            swap_(j, j - 1);
+        }
+    }
+}
+
+std::vector<Game*> topK(const std::vector<Game*>& games, size_t count, const GameComparator comparator) {
+    count = std::min(count, games.size());
+    if (count == 0) {
+        return {};
+    }
+    const trace::Span span("top k", std::to_string(count));
+    // A max-heap of the best games so far, by comparator and then position, so the worst kept game is on top
+    using Entry = std::pair<Game*, size_t>;
+    const auto less = [comparator](const Entry& lhs, const Entry& rhs) {
+        if (comparator(lhs.first, rhs.first)) {
+            return true;
+        }
+        return !comparator(rhs.first, lhs.first) && lhs.second < rhs.second;
+    };
+    std::vector<Entry> heap;
+    heap.reserve(count);
+    for (size_t i = 0; i < games.size(); ++i) {
+        const Entry entry(games[i], i);
+        if (heap.size() < count) {
+            heap.push_back(entry);
+            std::ranges::push_heap(heap, less);
+        } else if (less(entry, heap.front())) {
+            std::ranges::pop_heap(heap, less);
+            heap.back() = entry;
+            std::ranges::push_heap(heap, less);
+        }
+    }
+    std::ranges::sort_heap(heap, less);
+    std::vector<Game*> result;
+    result.reserve(heap.size());
+    for (const auto& entry : heap) {
+        result.push_back(entry.first);
+    }
+    return result;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Game.hpp"
+#include "sorts.hpp"
+
+/**
+ * @brief Sorts games a prefix at a time, so the first page of an order is ready long before the rest
+ *
+ * Incremental quicksort: only the part of the unsorted range that holds the next games is
+ * partitioned, and the pivots already in place are kept on a stack so the next call goes
+ * on from there. Sorting the first k of n games costs O(n + k log k) expected, and sorting
+ * all of them in steps costs about as much as one quicksort.
+ *
+ * Ties are broken by the games' positions when the sort started, so every prefix is the
+ * same as std::stable_sort's. The games stay a permutation of the input throughout, only
+ * the first getSortedCount() of them are in their final place.
+ */
+class IncrementalSort {
+public:
+    // Sorts games in place, which must outlive the sort
+    IncrementalSort(std::vector<Game*>& games, GameComparator comparator);
+
+    // Put at least the first count games in their final place
+    void sortPrefix(size_t count);
+
+    [[nodiscard("Getter")]] size_t getSortedCount() const;
+
+    [[nodiscard("Getter")]] bool done() const;
+
+private:
+    // Ranges this short are insertion sorted whole instead of partitioned further
+    static constexpr size_t INSERTION_LIMIT_ = 16;
+
+    std::vector<Game*>& games_;
+    GameComparator comparator_;
+    // Where each game was when the sort started, moved along with it
+    std::vector<uint32_t> positions_;
+    // Positions of the pivots that are in place, nearest last. The bottom is the end of the games.
+    std::vector<size_t> pivots_;
+    size_t sorted_ = 0;
+
+    [[nodiscard("Getter")]] bool less_(size_t lhs, size_t rhs) const;
+
+    void swap_(size_t lhs, size_t rhs);
+
+    // Partition [first, last) around the median of its first, middle and last game, return the pivot's position
+    size_t partition_(size_t first, size_t last);
+
+    void insertionSort_(size_t first, size_t last);
+};
+
+/**
+ * @brief The first count games in comparator order, sorted
+ *
+ * Keeps the best count games seen so far in a heap, O(n log count). Ties go to the earlier
+ * game, so the result is the first count games std::stable_sort would produce.
+ */
+std::vector<Game*> topK(const std::vector<Game*>& games, size_t count, GameComparator comparator);
@@ -0,0 +1,179 @@
+#include "perfcounters.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <sstream>
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+#ifdef __linux__
+    struct EventConfig_ {
+        uint32_t type;
+        uint64_t config;
+    };
+
+    constexpr uint64_t cacheMisses_(const uint64_t cache) {
+        return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    }
+
+    // In the order of perf::Event
+    constexpr std::array<EventConfig_, perf::EVENT_COUNT> EVENT_CONFIGS = {{
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HW_CACHE, cacheMisses_(PERF_COUNT_HW_CACHE_L1D)},
+        {PERF_TYPE_HW_CACHE, cacheMisses_(PERF_COUNT_HW_CACHE_LL)},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        {PERF_TYPE_HW_CACHE, cacheMisses_(PERF_COUNT_HW_CACHE_DTLB)},
+    }};
+
+    // One file descriptor per event, -1 for the events that couldn't be opened
+    class ThreadCounters_ {
+    public:
+        ThreadCounters_() {
+            int firstError = 0;
+            for (size_t i = 0; i < perf::EVENT_COUNT; ++i) {
+                perf_event_attr attributes{};
+                attributes.size = sizeof(attributes);
+                attributes.type = EVENT_CONFIGS[i].type;
+                attributes.config = EVENT_CONFIGS[i].config;
+                attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+                // Counting only user space works under the default perf_event_paranoid of most distributions
+                attributes.exclude_kernel = 1;
+                attributes.exclude_hv = 1;
+                // This thread on any CPU, each event on its own so that one unsupported event doesn't take the rest
+                fds_[i] = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1,
+                                                   PERF_FLAG_FD_CLOEXEC));
+                if (fds_[i] < 0 && firstError == 0) {
+                    firstError = errno;
+                }
+            }
+            if (firstError != 0) {
+                warnOnce_(firstError);
+            }
+        }
+
+        ~ThreadCounters_() {
+            for (const int fd : fds_) {
+                if (fd >= 0) {
+                    close(fd);
+                }
+            }
+        }
+
+        ThreadCounters_(const ThreadCounters_&) = delete;
+
+        ThreadCounters_& operator=(const ThreadCounters_&) = delete;
+
+        perf::CounterValues read() const {
+            perf::CounterValues values;
+            for (size_t i = 0; i < perf::EVENT_COUNT; ++i) {
+                // value, time enabled, time running
+                uint64_t reading[3];
+                if (fds_[i] < 0 || ::read(fds_[i], reading, sizeof(reading)) != sizeof(reading)) {
+                    continue;
+                }
+                values.counts[i] = reading[2] == 0 || reading[2] == reading[1]
+                                       ? reading[0]
+                                       : static_cast<uint64_t>(static_cast<double>(reading[0]) *
+                                                               static_cast<double>(reading[1]) /
+                                                               static_cast<double>(reading[2]));
+                values.available |= 1u << i;
+            }
+            return values;
+        }
+
+    private:
+        std::array<int, perf::EVENT_COUNT> fds_{};
+
+        static void warnOnce_(const int error) {
+            static std::atomic_flag warned;
+            if (!warned.test_and_set()) {
+                fprintf(stderr, "some hardware counters are unavailable (%s), they are left out\n",
+                        std::strerror(error));
+            }
+        }
+    };
+#endif
+}
+
+namespace perf {
+    const char* eventName(const Event event) {
+        switch (event) {
+            case Event::Cycles:
+                return "cycles";
+            case Event::Instructions:
+                return "instructions";
+            case Event::L1dMisses:
+                return "l1d_misses";
+            case Event::LlcMisses:
+                return "llc_misses";
+            case Event::BranchMisses:
+                return "branch_misses";
+            case Event::DtlbMisses:
+                return "dtlb_misses";
+        }
+        return "unknown";
+    }
+
+    CounterValues& CounterValues::operator+=(const CounterValues& rhs) {
+        for (size_t i = 0; i < EVENT_COUNT; ++i) {
+            counts[i] += rhs.counts[i];
+        }
+        available |= rhs.available;
+        return *this;
+    }
+
+    double CounterValues::ipc() const {
+        if (!has(Event::Cycles) || !has(Event::Instructions) || (*this)[Event::Cycles] == 0) {
+            return 0.0;
+        }
+        return static_cast<double>((*this)[Event::Instructions]) / static_cast<double>((*this)[Event::Cycles]);
+    }
+
+    CounterValues operator-(const CounterValues& end, const CounterValues& start) {
+        CounterValues difference;
+        difference.available = end.available & start.available;
+        for (size_t i = 0; i < EVENT_COUNT; ++i) {
+            // Scaled readings of a multiplexed event aren't guaranteed to be monotonic
+            difference.counts[i] = end.counts[i] > start.counts[i] ? end.counts[i] - start.counts[i] : 0;
+        }
+        return difference;
+    }
+
+    CounterValues readCounters() {
+#ifdef __linux__
+        static thread_local const ThreadCounters_ threadCounters;
+        return threadCounters.read();
+#else
+        return {};
+#endif
+    }
+
+    bool countersAvailable() {
+        return readCounters().available != 0;
+    }
+
+    std::string countersJson(const CounterValues& values, const double divisor) {
+        std::ostringstream json;
+        json << '{';
+        bool first = true;
+        for (size_t i = 0; i < EVENT_COUNT; ++i) {
+            const auto event = static_cast<Event>(i);
+            if (!values.has(event)) {
+                continue;
+            }
+            json << (first ? "" : ", ") << '"' << eventName(event) << "\": "
+                 << static_cast<double>(values[event]) / divisor;
+            first = false;
+        }
+        json << '}';
+        return json.str();
+    }
+}
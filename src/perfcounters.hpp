@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/*
+ * Hardware performance counters of the calling thread, read through Linux perf_event_open.
+ *
+ * Counters are opened the first time a thread reads them and stay enabled until it exits. Events that can't be
+ * opened, e.g. in a container, under a restrictive perf_event_paranoid, in a VM without a virtual PMU or on
+ * another OS, are simply missing from the values: nothing fails, the reports leave them out.
+ */
+namespace perf {
+    enum class Event {
+        Cycles,
+        Instructions,
+        L1dMisses,
+        LlcMisses,
+        BranchMisses,
+        DtlbMisses
+    };
+
+    constexpr size_t EVENT_COUNT = 6;
+
+    // Short name of an event, as used in benchmark output
+    const char* eventName(Event event);
+
+    /**
+     * @brief Counts of every event, or the difference of two readings
+     *
+     * Only events whose bit is set in available were counted, the others read as 0.
+     */
+    struct CounterValues {
+        std::array<uint64_t, EVENT_COUNT> counts{};
+        uint32_t available = 0;
+
+        bool has(const Event event) const {
+            return (available & (1u << static_cast<unsigned>(event))) != 0;
+        }
+
+        uint64_t operator[](const Event event) const {
+            return counts[static_cast<size_t>(event)];
+        }
+
+        CounterValues& operator+=(const CounterValues& rhs);
+
+        // Instructions per cycle, 0 if either wasn't counted
+        double ipc() const;
+    };
+
+    // Counts between two readings of the same thread
+    CounterValues operator-(const CounterValues& end, const CounterValues& start);
+
+    /**
+     * @brief Read the counters of the calling thread
+     *
+     * The first call on a thread opens the counters. Counts are scaled up when the
+     * kernel had to multiplex them with other events.
+     */
+    CounterValues readCounters();
+
+    // True if the calling thread could open at least one event
+    bool countersAvailable();
+
+    /**
+     * @brief Write the counted events as a JSON object, e.g. {"cycles": 120, "instructions": 300}
+     *
+     * @param values Counts to write
+     * @param divisor Every count is divided by this, e.g. the number of elements sorted
+     */
+    std::string countersJson(const CounterValues& values, double divisor = 1.0);
+}
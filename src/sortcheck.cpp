@@ -0,0 +1,289 @@
+#include "sortcheck.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <set>
+#include <tuple>
+#include <ranges>
+
+namespace {
+    const std::array<const char*, 6> TITLE_WORDS_ = {"Doom", "doom", "Quest", "Quest II", "Zelda", ""};
+    const std::array<const char*, 5> GENRES_ = {"Action", "Adventure", "RPG", "Strategy", "Sports"};
+    const std::array<const char*, 4> PLATFORMS_ = {"PC", "Switch", "Xbox", "PlayStation"};
+    const std::array<const char*, 5> CASED_PLATFORMS_ = {"PC", "pc", "Pc", "Xbox", "xbox"};
+
+    template<size_t N>
+    const char* pick_(const std::array<const char*, N>& choices, std::mt19937_64& generator) {
+        return choices[std::uniform_int_distribution<size_t>(0, N - 1)(generator)];
+    }
+
+    // Scores on a coarse grid collide often
+    double score_(std::mt19937_64& generator) {
+        return static_cast<double>(std::uniform_int_distribution<int>(0, 20)(generator)) / 2.0;
+    }
+
+    std::vector<std::string> genres_(std::mt19937_64& generator, const size_t maximum) {
+        std::vector<std::string> genres;
+        const size_t count = std::uniform_int_distribution<size_t>(0, maximum)(generator);
+        for (size_t i = 0; i < count; ++i) {
+            genres.emplace_back(pick_(GENRES_, generator));
+        }
+        return genres;
+    }
+
+    Game* variedGame_(std::mt19937_64& generator, const uint64_t id) {
+        return new Game(std::string(pick_(TITLE_WORDS_, generator)) + pick_(TITLE_WORDS_, generator),
+                        genres_(generator, 3), score_(generator), pick_(PLATFORMS_, generator), id);
+    }
+
+    // "equal" if neither game is ordered before the other
+    bool equivalent_(const GameComparator compare, const Game* lhs, const Game* rhs) {
+        return !compare(lhs, rhs) && !compare(rhs, lhs);
+    }
+}
+
+const std::array<GamePool, 6> GAME_POOLS = {
+    GamePool::Varied, GamePool::Duplicates, GamePool::SameKeys, GamePool::EmptyFields, GamePool::GenrePrefixes,
+    GamePool::PlatformCase
+};
+
+const char* gamePoolName(const GamePool pool) {
+    switch (pool) {
+        case GamePool::Duplicates:
+            return "duplicates";
+        case GamePool::SameKeys:
+            return "same_keys";
+        case GamePool::EmptyFields:
+            return "empty_fields";
+        case GamePool::GenrePrefixes:
+            return "genre_prefixes";
+        case GamePool::PlatformCase:
+            return "platform_case";
+        case GamePool::Varied:
+        default:
+            return "varied";
+    }
+}
+
+std::vector<Game*> makeGamePool(const GamePool pool, const size_t count, std::mt19937_64& generator) {
+    std::vector<Game*> games;
+    games.reserve(count);
+    // A handful of templates that the duplicates are copied from
+    std::vector<Game*> templates;
+    for (size_t i = 0; pool == GamePool::Duplicates && i < 4; ++i) {
+        templates.push_back(variedGame_(generator, i + 1));
+    }
+
+    for (uint64_t id = 1; id <= count; ++id) {
+        switch (pool) {
+            case GamePool::Duplicates:
+                games.push_back(new Game(*templates[std::uniform_int_distribution<size_t>(0, 3)(generator)]));
+                break;
+            case GamePool::SameKeys:
+                games.push_back(new Game("Same", {"Action", "RPG"}, 7.5, "PC", id));
+                break;
+            case GamePool::EmptyFields:
+                if (std::bernoulli_distribution(0.5)(generator)) {
+                    games.push_back(new Game("", {}, 0.0, pick_(PLATFORMS_, generator), id));
+                } else {
+                    games.push_back(variedGame_(generator, id));
+                }
+                break;
+            case GamePool::GenrePrefixes: {
+                // The first n genres in a fixed order, so every list is a prefix of the longer ones
+                const size_t length = std::uniform_int_distribution<size_t>(0, GENRES_.size())(generator);
+                std::vector<std::string> genres(GENRES_.begin(), GENRES_.begin() + static_cast<long long>(length));
+                games.push_back(new Game(pick_(TITLE_WORDS_, generator), std::move(genres), score_(generator),
+                                         pick_(PLATFORMS_, generator), id));
+                break;
+            }
+            case GamePool::PlatformCase:
+                games.push_back(new Game(pick_(TITLE_WORDS_, generator), genres_(generator, 2), score_(generator),
+                                         pick_(CASED_PLATFORMS_, generator), id));
+                break;
+            case GamePool::Varied:
+            default:
+                games.push_back(variedGame_(generator, id));
+                break;
+        }
+    }
+    for (const Game* game : templates) {
+        delete game;
+    }
+    return games;
+}
+
+std::string checkSort(const SortAlgorithm& algorithm, const SortComparator& comparator,
+                      const std::vector<Game*>& input) {
+    std::vector<Game*> result = input;
+    algorithm.sort(result, comparator.compare);
+    if (result.size() != input.size()) {
+        return "size changed from " + std::to_string(input.size()) + " to " + std::to_string(result.size());
+    }
+
+    std::vector<Game*> inputGames = input;
+    std::vector<Game*> resultGames = result;
+    std::ranges::sort(inputGames, std::less<>());
+    std::ranges::sort(resultGames, std::less<>());
+    if (inputGames != resultGames) {
+        return "result isn't a permutation of the input";
+    }
+
+    for (size_t i = 1; i < result.size(); ++i) {
+        if (comparator.compare(result[i], result[i - 1])) {
+            return "out of order at index " + std::to_string(i);
+        }
+    }
+
+    // Two correct stable sorts of the same input under a strict weak ordering produce the same sequence
+    std::vector<Game*> expected = input;
+    std::ranges::stable_sort(expected, comparator.compare);
+    for (size_t i = 0; i < result.size(); ++i) {
+        if (result[i] != expected[i]) {
+            return "not stable, equal games swapped at index " + std::to_string(i);
+        }
+    }
+    return "";
+}
+
+std::string checkCompositeSort(const std::vector<SortKey>& keys, const std::vector<Game*>& input) {
+    std::vector<Game*> result = input;
+    compositeSort(result, keys);
+    std::vector<Game*> expected = input;
+    std::ranges::stable_sort(expected, [&](const Game* lhs, const Game* rhs) {
+        return compositeLess(keys, lhs, rhs);
+    });
+    if (result.size() != expected.size()) {
+        return "size changed from " + std::to_string(input.size()) + " to " + std::to_string(result.size());
+    }
+    for (size_t i = 0; i < result.size(); ++i) {
+        if (result[i] != expected[i]) {
+            return "differs from std::stable_sort at index " + std::to_string(i);
+        }
+    }
+    return "";
+}
+
+std::string checkPartialSort(const SortComparator& comparator, const std::vector<Game*>& input, size_t count) {
+    count = std::min(count, input.size());
+    std::vector<Game*> expected = input;
+    std::ranges::stable_sort(expected, comparator.compare);
+
+    std::vector<Game*> result = input;
+    IncrementalSort sort(result, comparator.compare);
+    // A single game, a third, then the rest, so that later calls have to continue from the pivots of earlier ones
+    for (const size_t prefix : {std::min<size_t>(1, count), count / 3, count}) {
+        sort.sortPrefix(prefix);
+        if (sort.getSortedCount() < prefix) {
+            return "only " + std::to_string(sort.getSortedCount()) + " of " + std::to_string(prefix) + " sorted";
+        }
+        for (size_t i = 0; i < prefix; ++i) {
+            if (result[i] != expected[i]) {
+                return "sorted prefix of " + std::to_string(prefix) + " differs from std::stable_sort at index " +
+                       std::to_string(i);
+            }
+        }
+    }
+    std::vector<Game*> inputGames = input;
+    std::vector<Game*> resultGames = result;
+    std::ranges::sort(inputGames, std::less<>());
+    std::ranges::sort(resultGames, std::less<>());
+    if (inputGames != resultGames) {
+        return "partially sorted games aren't a permutation of the input";
+    }
+
+    const std::vector<Game*> top = topK(input, count, comparator.compare);
+    if (top.size() != count || !std::ranges::equal(top, expected | std::views::take(count))) {
+        return "top " + std::to_string(count) + " differs from std::stable_sort";
+    }
+    return "";
+}
+
+std::string checkGameGroups(const std::vector<Game*>& games, const uint64_t ids) {
+    std::vector<Game*> copies;
+    copies.reserve(games.size());
+    for (const Game* game : games) {
+        copies.push_back(new Game(game->get_title(), game->get_genres(), game->get_score(), game->get_platform(),
+                                  game->get_id() % std::max<uint64_t>(ids, 1), game->get_release_year()));
+    }
+
+    // The same rules as dedupGames, spelled out with ordered maps
+    std::set<std::tuple<std::string, uint64_t, std::string>> seen;
+    std::vector<Game*> expectedKept;
+    for (Game* game : copies) {
+        const std::string title = game->get_id() == 0 ? normalizeKey(game->get_title()) : "";
+        if (seen.emplace(normalizeKey(game->get_platform()), game->get_id(), title).second) {
+            expectedKept.push_back(game);
+        }
+    }
+    std::map<std::pair<uint64_t, std::string>, size_t> groupOfKey;
+    std::vector<std::vector<Game*>> expectedGroups;
+    for (Game* game : expectedKept) {
+        const std::string title = game->get_id() == 0 ? normalizeKey(game->get_title()) : "";
+        const auto [group, added] = groupOfKey.try_emplace({game->get_id(), title}, expectedGroups.size());
+        if (added) {
+            expectedGroups.emplace_back();
+        }
+        expectedGroups[group->second].push_back(game);
+    }
+    for (auto& group : expectedGroups) {
+        std::ranges::stable_sort(group, {}, [](const Game* game) {
+            return normalizeKey(game->get_platform());
+        });
+    }
+
+    GameGroups groups;
+    const size_t duplicates = dedupGames(copies, &groups);
+    const std::string error = [&]() -> std::string {
+        if (copies != expectedKept || duplicates != games.size() - expectedKept.size()) {
+            return "kept " + std::to_string(copies.size()) + " games, expected " +
+                   std::to_string(expectedKept.size());
+        }
+        if (groups.size() != expectedGroups.size()) {
+            return std::to_string(groups.size()) + " groups, expected " + std::to_string(expectedGroups.size());
+        }
+        if (groups.offsets.empty() || groups.offsets.front() != 0 || groups.offsets.back() != groups.members.size() ||
+            groups.members.size() != copies.size()) {
+            return "offsets don't cover the " + std::to_string(copies.size()) + " kept games";
+        }
+        for (size_t group = 0; group < groups.size(); ++group) {
+            if (groups.offsets[group] > groups.offsets[group + 1] ||
+                !std::ranges::equal(groups.group(group), expectedGroups[group])) {
+                return "group " + std::to_string(group) + " differs";
+            }
+        }
+        return "";
+    }();
+    for (const Game* game : copies) {
+        delete game;
+    }
+    return error;
+}
+
+std::string checkComparator(const SortComparator& comparator, const std::vector<Game*>& games,
+                            const size_t samples, std::mt19937_64& generator) {
+    if (games.empty()) {
+        return "";
+    }
+    const GameComparator compare = comparator.compare;
+    std::uniform_int_distribution<size_t> pick(0, games.size() - 1);
+    for (size_t sample = 0; sample < samples; ++sample) {
+        const Game* a = games[pick(generator)];
+        const Game* b = games[pick(generator)];
+        const Game* c = games[pick(generator)];
+        if (compare(a, a)) {
+            return "not irreflexive: a game is ordered before itself";
+        }
+        if (compare(a, b) && compare(b, a)) {
+            return "not asymmetric: two games are each ordered before the other";
+        }
+        if (compare(a, b) && compare(b, c) && !compare(a, c)) {
+            return "not transitive: a < b and b < c but not a < c";
+        }
+        if (equivalent_(compare, a, b) && equivalent_(compare, b, c) && !equivalent_(compare, a, c)) {
+            return "equivalence isn't transitive: a == b and b == c but a != c";
+        }
+    }
+    return "";
+}
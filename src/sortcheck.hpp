@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Game.hpp"
+#include "compositesort.hpp"
+#include "dedup.hpp"
+#include "partialsort.hpp"
+#include "sorts.hpp"
+
+// Sets of games built to provoke sorting bugs, see makeGamePool()
+enum class GamePool {
+    Varied,
+    Duplicates,
+    SameKeys,
+    EmptyFields,
+    GenrePrefixes,
+    PlatformCase
+};
+
+extern const std::array<GamePool, 6> GAME_POOLS;
+
+// Short name of a game pool, as used in verification output
+const char* gamePoolName(GamePool pool);
+
+/**
+ * @brief Build games that stress one kind of edge case
+ *
+ * @param pool Kind of games to build
+ * @param count Number of games
+ * @param generator Source of randomness
+ * @return New games, owned by the caller
+ *
+ * Varied: titles, scores, genres and platforms from small sets, so some keys collide.
+ * Duplicates: copies of a handful of games, identical in every field, so most comparisons are ties.
+ * SameKeys: identical except for their ids, so every field but the id ties.
+ * EmptyFields: empty titles, no genres and scores of 0 mixed with ordinary games.
+ * GenrePrefixes: genre lists that are prefixes of each other, e.g. {Action} and {Action, RPG}.
+ * PlatformCase: platforms that differ only in case, e.g. PC and pc.
+ */
+std::vector<Game*> makeGamePool(GamePool pool, size_t count, std::mt19937_64& generator);
+
+/**
+ * @brief Sort a copy of the input and check the result
+ *
+ * @param algorithm Sort to check
+ * @param comparator Ordering to sort by
+ * @param input Games to sort, never modified. The same game may appear more than once.
+ * @return An empty string if the result is correct, otherwise what is wrong with it
+ *
+ * The result must be a permutation of the input, in order, and identical to
+ * std::stable_sort's result, i.e. games that compare equal keep their input order.
+ */
+std::string checkSort(const SortAlgorithm& algorithm, const SortComparator& comparator,
+                      const std::vector<Game*>& input);
+
+/**
+ * @brief Sort a copy of the input with compositeSort and check the result
+ *
+ * @return An empty string if the result is identical to std::stable_sort's with compositeLess,
+ * otherwise the first difference
+ */
+std::string checkCompositeSort(const std::vector<SortKey>& keys, const std::vector<Game*>& input);
+
+/**
+ * @brief Sort prefixes of a copy of the input with IncrementalSort and take topK, and check both
+ *
+ * @param count Games to sort, in a few growing steps up to count
+ * @return An empty string if the sorted prefixes equal std::stable_sort's and the games stayed a
+ * permutation of the input, otherwise what is wrong
+ */
+std::string checkPartialSort(const SortComparator& comparator, const std::vector<Game*>& input, size_t count);
+
+/**
+ * @brief Deduplicate copies of the games with dedupGames() and check the kept games and the group table
+ *
+ * @param games Games to copy, never modified
+ * @param ids The copies get their id modulo ids, so that many of them share an id and those
+ * with id 0 are grouped by title
+ * @return An empty string if the kept games and the groups match a straightforward map-based
+ * grouping, otherwise the first difference
+ *
+ * Checks that the first game of every (platform, id or title) is kept in order, that the offsets
+ * cover the members, that every kept game is a member of exactly one group, that groups are
+ * ordered by first appearance and that each one is ordered by platform.
+ */
+std::string checkGameGroups(const std::vector<Game*>& games, uint64_t ids);
+
+/**
+ * @brief Check that a comparator is a strict weak ordering on random samples of games
+ *
+ * @return An empty string if no violation was found, otherwise the first one
+ *
+ * Checks irreflexivity, asymmetry, transitivity and transitivity of equivalence
+ * on triples drawn from games. Sorting with a comparator that breaks these has no
+ * well-defined result, so a failure here explains failures of checkSort().
+ */
+std::string checkComparator(const SortComparator& comparator, const std::vector<Game*>& games, size_t samples,
+                            std::mt19937_64& generator);
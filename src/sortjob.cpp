@@ -0,0 +1,101 @@
+#include "sortjob.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+#include "allocprofile.hpp"
+#include "trace.hpp"
+
+SortJob::SortJob(std::vector<Game*> input, const GameComparator comparator,
+                 std::vector<const SortAlgorithm*> algorithms) : input_(std::move(input)), comparator_(comparator),
+                                                                 algorithms_(std::move(algorithms)),
+                                                                 progress_(algorithms_.size()),
+                                                                 runs_(algorithms_.size()),
+                                                                 results_(algorithms_.size()) {
+    for (size_t i = 0; i < algorithms_.size(); ++i) {
+        progress_[i].setTotal(algorithms_[i]->work(input_.size()));
+    }
+    // Started last, everything the worker touches is constructed by now
+    worker_ = std::thread(&SortJob::work_, this);
+}
+
+SortJob::~SortJob() {
+    cancelAll();
+    worker_.join();
+}
+
+size_t SortJob::size() const {
+    return algorithms_.size();
+}
+
+const SortAlgorithm& SortJob::algorithm(const size_t index) const {
+    return *algorithms_[index];
+}
+
+const progress::SortProgress& SortJob::progress(const size_t index) const {
+    return progress_[index];
+}
+
+void SortJob::cancel(const size_t index) {
+    progress_[index].cancel();
+}
+
+void SortJob::cancelAll() {
+    for (auto& algorithmProgress : progress_) {
+        algorithmProgress.cancel();
+    }
+}
+
+bool SortJob::done() const {
+    return done_.load(std::memory_order_acquire);
+}
+
+const SortRun& SortJob::run(const size_t index) const {
+    return runs_[index];
+}
+
+std::vector<Game*>& SortJob::result(const size_t index) {
+    return results_[index];
+}
+
+const std::vector<Game*>& SortJob::input() const {
+    return input_;
+}
+
+void SortJob::work_() {
+    for (size_t i = 0; i < algorithms_.size(); ++i) {
+        if (progress_[i].cancelled()) {
+            continue;
+        }
+        results_[i] = input_;
+        try {
+            const progress::Reporter reporter(progress_[i]);
+            runs_[i] = runSort(*algorithms_[i], results_[i], comparator_);
+            // Some totals are upper bounds, a finished sort is all the way done
+            progress_[i].add(progress_[i].total() - std::min(progress_[i].done(), progress_[i].total()));
+        } catch (const progress::SortCancelled&) {
+            instr::endCounting();
+            results_[i].clear();
+            results_[i].shrink_to_fit();
+        }
+    }
+    // Release, so the runs and results are visible to whoever sees done()
+    done_.store(true, std::memory_order_release);
+}
+
+SortRun runSort(const SortAlgorithm& algorithm, std::vector<Game*>& games, const GameComparator comparator) {
+    using std::chrono::duration_cast;
+    using millis = std::chrono::milliseconds;
+    using clock = std::chrono::high_resolution_clock;
+
+    const trace::Span span("sort", std::string(algorithm.name) + ", " + std::to_string(games.size()) + " games");
+    const heap::Phase phase(std::string("sort ") + algorithm.name);
+    instr::beginCounting();
+    const perf::CounterValues eventsStart = perf::readCounters();
+    const auto timeStart = clock::now();
+    algorithm.sort(games, instr::countComparisons(comparator));
+    const long long time = (duration_cast<millis>(clock::now() - timeStart)).count();
+    const perf::CounterValues events = perf::readCounters() - eventsStart;
+    return {true, time, instr::endCounting(), events};
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "Game.hpp"
+#include "instrument.hpp"
+#include "perfcounters.hpp"
+#include "sortprogress.hpp"
+#include "sorts.hpp"
+
+// What the sorting window shows about one sort
+struct SortRun {
+    // False if the sort was cancelled, the rest is then empty
+    bool finished = false;
+    long long milliseconds = 0;
+    instr::SortCounters counts;
+    perf::CounterValues events;
+};
+
+/**
+ * @brief Times several sorts of the same input, one after another on a worker thread
+ *
+ * Every algorithm sorts its own copy of the input, so the timings are comparable. The
+ * thread that owns the job polls progress() and done(), and can cancel any algorithm
+ * before or while it runs. The destructor cancels whatever is left and waits for the worker.
+ */
+class SortJob {
+public:
+    /**
+     * @param input Games to sort, copied
+     * @param comparator Order to sort them in
+     * @param algorithms Algorithms to run, in order
+     */
+    SortJob(std::vector<Game*> input, GameComparator comparator, std::vector<const SortAlgorithm*> algorithms);
+
+    ~SortJob();
+
+    SortJob(const SortJob& rhs) = delete;
+
+    SortJob& operator=(const SortJob& rhs) = delete;
+
+    [[nodiscard("Getter")]] size_t size() const;
+
+    [[nodiscard("Getter")]] const SortAlgorithm& algorithm(size_t index) const;
+
+    [[nodiscard("Getter")]] const progress::SortProgress& progress(size_t index) const;
+
+    // Skip an algorithm, or stop it if it is running
+    void cancel(size_t index);
+
+    void cancelAll();
+
+    // True once every algorithm finished or was cancelled
+    [[nodiscard("Getter")]] bool done() const;
+
+    // Only valid once done()
+    [[nodiscard("Getter")]] const SortRun& run(size_t index) const;
+
+    /**
+     * @brief The games sorted by an algorithm, only valid once done()
+     *
+     * Empty if the algorithm was cancelled.
+     */
+    [[nodiscard("Getter")]] std::vector<Game*>& result(size_t index);
+
+    [[nodiscard("Getter")]] const std::vector<Game*>& input() const;
+
+private:
+    std::vector<Game*> input_;
+    GameComparator comparator_;
+    std::vector<const SortAlgorithm*> algorithms_;
+    std::vector<progress::SortProgress> progress_;
+    std::vector<SortRun> runs_;
+    std::vector<std::vector<Game*>> results_;
+    std::atomic<bool> done_{false};
+    std::thread worker_;
+
+    void work_();
+};
+
+/**
+ * @brief Time one sort on the calling thread and collect its counters, allocations and trace span
+ *
+ * Allocations are profiled under the phase "sort <algorithm name>".
+ */
+SortRun runSort(const SortAlgorithm& algorithm, std::vector<Game*>& games, GameComparator comparator);
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+
+/*
+ * Progress reporting and cooperative cancellation for the sorting algorithms.
+ *
+ * A thread that sorts on behalf of another one points a Reporter at a SortProgress. The sorts then call advance()
+ * as they go, which adds to the progress and throws SortCancelled once another thread called cancel(). Without a
+ * Reporter, advance() is a single thread-local load, so the benchmarks and the synchronous sorts pay next to nothing.
+ */
+namespace progress {
+    // Thrown out of a sort by advance() after its progress was cancelled
+    class SortCancelled : public std::runtime_error {
+    public:
+        SortCancelled() : std::runtime_error("sort cancelled") {}
+    };
+
+    /**
+     * @brief How far one sort got, written by the sorting thread and read by any other
+     *
+     * The unit of work depends on the algorithm, e.g. elements merged, see SortAlgorithm::work.
+     */
+    class SortProgress {
+    public:
+        void setTotal(const uint64_t total) {
+            total_.store(total, std::memory_order_relaxed);
+        }
+
+        void add(const uint64_t work) {
+            done_.fetch_add(work, std::memory_order_relaxed);
+        }
+
+        [[nodiscard("Getter")]] uint64_t done() const {
+            return done_.load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard("Getter")]] uint64_t total() const {
+            return total_.load(std::memory_order_relaxed);
+        }
+
+        // Between 0 and 1, the totals are estimates for some algorithms so this is clamped
+        [[nodiscard("Getter")]] double fraction() const {
+            const uint64_t total = this->total();
+            return total == 0 ? 0.0 : std::min(1.0, static_cast<double>(done()) / static_cast<double>(total));
+        }
+
+        // Ask the sort to stop at its next advance()
+        void cancel() {
+            cancelled_.store(true, std::memory_order_relaxed);
+        }
+
+        [[nodiscard("Getter")]] bool cancelled() const {
+            return cancelled_.load(std::memory_order_relaxed);
+        }
+
+    private:
+        std::atomic<uint64_t> done_{0};
+        std::atomic<uint64_t> total_{0};
+        std::atomic<bool> cancelled_{false};
+    };
+
+    // Progress the sorts of the current thread report to, nullptr if nobody is watching
+    inline SortProgress*& current() {
+        static thread_local SortProgress* progress = nullptr;
+        return progress;
+    }
+
+    // Report the sorts of the current thread to a progress while alive
+    class Reporter {
+    public:
+        explicit Reporter(SortProgress& progress) : previous_(current()) {
+            current() = &progress;
+        }
+
+        ~Reporter() {
+            current() = previous_;
+        }
+
+        Reporter(const Reporter& rhs) = delete;
+
+        Reporter& operator=(const Reporter& rhs) = delete;
+
+    private:
+        SortProgress* previous_;
+    };
+
+    /**
+     * @brief Add work to the current thread's progress, if any
+     *
+     * Throws SortCancelled if the progress was cancelled. The vector that was
+     * being sorted is then in an unspecified state and should be thrown away.
+     */
+    inline void advance(const uint64_t work) {
+        SortProgress* progress = current();
+        if (progress == nullptr) {
+            return;
+        }
+        progress->add(work);
+        if (progress->cancelled()) {
+            throw SortCancelled();
+        }
+    }
+}
@@ -0,0 +1,74 @@
+#include "sorts.hpp"
+
+#include <algorithm>
+#include <bit>
+
+#include "instrument.hpp"
+#include "mergesort.hpp"
+#include "sortprogress.hpp"
+#include "timsort.hpp"
+
+namespace {
+    // Levels of a merge sort of that many elements or runs
+    uint64_t mergeLevels_(const size_t count) {
+        return count < 2 ? 0 : std::bit_width(count - 1);
+    }
+
+    // Every game is inserted into a 512 game run, then every level of merges merges every game
+    uint64_t timsortWork_(const size_t elements) {
+        return elements + elements * mergeLevels_((elements + 511) / 512);
+    }
+
+    // Every level of the recursion merges at most every game
+    uint64_t mergeSortWork_(const size_t elements) {
+        return elements * mergeLevels_(elements);
+    }
+
+    // Every game is inserted once, later ones take longer as they shift more games
+    uint64_t binaryInsertionSortWork_(const size_t elements) {
+        return elements;
+    }
+
+    // Comparisons, which std::stable_sort keeps at or under n log2 n when it has a buffer
+    uint64_t stableSortWork_(const size_t elements) {
+        return elements * mergeLevels_(elements);
+    }
+}
+
+const std::array<SortAlgorithm, 4> SORT_ALGORITHMS = {{
+    {"timsort", ts::timsort, false, timsortWork_},
+    {"mergesort", ms::mergeSort, false, mergeSortWork_},
+    {"binary_insertion_sort", ts::binaryInsertionSort, true, binaryInsertionSortWork_},
+    {"std::stable_sort", stableSort, false, stableSortWork_},
+}};
+
+const std::array<SortComparator, 4> SORT_COMPARATORS = {{
+    {"title", Game::compareTitles},
+    {"rating", Game::compareScores},
+    {"genre", Game::compareGenres},
+    {"platform", Game::comparePlatform},
+}};
+
+void stableSort(std::vector<Game*>& games, const GameComparator comparator) {
+    if constexpr (instr::ENABLED) {
+        // std::stable_sort can't be instrumented from the inside, so sort elements that count their own moves
+        std::vector<instr::CountedElement<Game*>> counted(games.begin(), games.end());
+        std::ranges::stable_sort(counted.begin(), counted.end(), [comparator](const auto& lhs, const auto& rhs) {
+            progress::advance(1);
+            return comparator(lhs.value, rhs.value);
+        });
+        std::ranges::transform(counted.begin(), counted.end(), games.begin(), [](const auto& element) {
+            return element.value;
+        });
+        return;
+    }
+    if (progress::current() != nullptr) {
+        // std::stable_sort can't report from the inside either, so its comparisons are the progress
+        std::ranges::stable_sort(games.begin(), games.end(), [comparator](const Game* lhs, const Game* rhs) {
+            progress::advance(1);
+            return comparator(lhs, rhs);
+        });
+        return;
+    }
+    std::ranges::stable_sort(games.begin(), games.end(), comparator);
+}
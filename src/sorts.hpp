@@ -0,0 +1,33 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "Game.hpp"
+
+using GameComparator = bool (*)(const Game* lhs, const Game* rhs);
+
+// A sorting function together with the name it is reported under
+struct SortAlgorithm {
+    const char* name;
+    void (*sort)(std::vector<Game*>& games, GameComparator comparator);
+    // O(n^2) algorithms are skipped by the benchmarks on large inputs
+    bool quadratic;
+    // Work the sort reports through progress::advance when sorting that many games, see sortprogress.hpp
+    uint64_t (*work)(size_t elements);
+};
+
+struct SortComparator {
+    const char* name;
+    GameComparator compare;
+};
+
+// Every sort that GameSort compares: ts::timsort, ms::mergeSort, ts::binaryInsertionSort and std::stable_sort
+extern const std::array<SortAlgorithm, 4> SORT_ALGORITHMS;
+
+// The fields games can be ordered by, in the order of the buttons in the main window
+extern const std::array<SortComparator, 4> SORT_COMPARATORS;
+
+// std::ranges::stable_sort with the same signature as the other sorts
+void stableSort(std::vector<Game*>& games, GameComparator comparator);
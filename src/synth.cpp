@@ -0,0 +1,228 @@
+#include "synth.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <random>
+#include <unordered_map>
+
+#include "inputorder.hpp"
+
+namespace {
+    // Turn a value -> count table into parallel value and weight vectors
+    template<typename Map, typename Value>
+    void toWeights_(const Map& counts, std::vector<Value>& values, std::vector<double>& weights) {
+        values.clear();
+        weights.clear();
+        for (const auto& [value, count] : counts) {
+            values.push_back(value);
+            weights.push_back(static_cast<double>(count));
+        }
+    }
+
+    // Count table indexed by size, e.g. number of words in a title
+    void addToHistogram_(std::vector<double>& histogram, const size_t index) {
+        if (histogram.size() <= index) {
+            histogram.resize(index + 1, 0.0);
+        }
+        ++histogram[index];
+    }
+
+    std::discrete_distribution<size_t> makeDistribution_(const std::vector<double>& weights, const double skew) {
+        std::vector<double> skewed(weights.size());
+        std::ranges::transform(weights.begin(), weights.end(), skewed.begin(), [skew](const double weight) {
+            return weight > 0.0 ? std::pow(weight, skew) : 0.0;
+        });
+        if (skewed.empty()) {
+            skewed.push_back(1.0);
+        }
+        return {skewed.begin(), skewed.end()};
+    }
+
+    bool (*comparatorFor_(const SynthOrder order))(const Game*, const Game*) {
+        switch (order) {
+            case SynthOrder::Score:
+                return Game::compareScores;
+            case SynthOrder::Genre:
+                return Game::compareGenres;
+            case SynthOrder::Platform:
+                return Game::comparePlatform;
+            case SynthOrder::Title:
+            default:
+                return Game::compareTitles;
+        }
+    }
+
+    // Sort the chunk, then scatter a random (1 - sortedness) share of it among their own positions
+    void applySortedness_(std::vector<Game*>& chunk, const SynthOptions& options, std::mt19937_64& generator) {
+        if (options.sortedness <= 0.0) {
+            return;
+        }
+        // stable_sort only needs the comparator to be consistent for equal keys, never reads out of bounds
+        std::stable_sort(chunk.begin(), chunk.end(), comparatorFor_(options.sortOrder));
+        perturbGames(chunk, 1.0 - options.sortedness, generator);
+    }
+
+    void writeJsonString_(std::ostream& out, const std::string& text) {
+        out << '"';
+        for (const unsigned char c : text) {
+            if (c == '"' || c == '\\') {
+                out << '\\' << static_cast<char>(c);
+            } else if (c < 0x20) {
+                constexpr char HEX[] = "0123456789abcdef";
+                out << "\\u00" << HEX[c >> 4] << HEX[c & 0xF];
+            } else {
+                out << static_cast<char>(c);
+            }
+        }
+        out << '"';
+    }
+}
+
+SynthModel learnSynthModel(const std::vector<Game*>& games) {
+    std::unordered_map<std::string, size_t> wordCounts;
+    std::map<std::string, size_t> genreCounts;
+    std::map<double, size_t> scoreCounts;
+    std::map<std::string, size_t> platformCounts;
+    std::map<int, size_t> yearCounts;
+    SynthModel model;
+
+    for (const Game* game : games) {
+        const std::string title = game->get_title();
+        size_t words = 0;
+        size_t wordStart = 0;
+        while (wordStart < title.size()) {
+            size_t wordEnd = title.find(' ', wordStart);
+            if (wordEnd == std::string::npos) {
+                wordEnd = title.size();
+            }
+            if (wordEnd > wordStart) {
+                ++wordCounts[title.substr(wordStart, wordEnd - wordStart)];
+                ++words;
+            }
+            wordStart = wordEnd + 1;
+        }
+        addToHistogram_(model.titleLengthWeights, words);
+
+        const std::vector<std::string> genres = game->get_genres();
+        for (const auto& genre : genres) {
+            ++genreCounts[genre];
+        }
+        addToHistogram_(model.genreCountWeights, genres.size());
+
+        // Scores have two decimals, round to avoid floating point noise in the table
+        ++scoreCounts[std::round(game->get_score() * 100.0) / 100.0];
+        ++platformCounts[game->get_platform()];
+        ++yearCounts[game->get_release_year()];
+    }
+
+    // Sort the vocabulary so that the model, and the generated data, don't depend on hash order
+    const std::map<std::string, size_t> sortedWords(wordCounts.begin(), wordCounts.end());
+    toWeights_(sortedWords, model.titleWords, model.titleWordWeights);
+    toWeights_(genreCounts, model.genres, model.genreWeights);
+    toWeights_(scoreCounts, model.scores, model.scoreWeights);
+    toWeights_(platformCounts, model.platforms, model.platformWeights);
+    toWeights_(yearCounts, model.releaseYears, model.releaseYearWeights);
+    // Titles always have at least one word
+    if (!model.titleLengthWeights.empty()) {
+        model.titleLengthWeights[0] = 0.0;
+    }
+    if (model.titleWords.empty()) {
+        model.titleWords.emplace_back("Game");
+        model.titleWordWeights.push_back(1.0);
+    }
+    if (model.platforms.empty()) {
+        model.platforms.emplace_back("Synthetic");
+        model.platformWeights.push_back(1.0);
+    }
+    return model;
+}
+
+void generateGames(const SynthModel& model, const SynthOptions& options,
+                   const std::function<void(std::vector<Game*>& chunk)>& consumer) {
+    std::mt19937_64 generator(options.seed);
+    auto titleWords = makeDistribution_(model.titleWordWeights, options.skew);
+    auto titleLengths = makeDistribution_(model.titleLengthWeights, options.skew);
+    auto genres = makeDistribution_(model.genreWeights, options.skew);
+    auto genreCounts = makeDistribution_(model.genreCountWeights, options.skew);
+    auto scores = makeDistribution_(model.scoreWeights, options.skew);
+    auto platforms = makeDistribution_(model.platformWeights, options.skew);
+    auto years = makeDistribution_(model.releaseYearWeights, options.skew);
+
+    const size_t chunkSize = std::max<size_t>(options.chunkSize, 1);
+    uint64_t nextId = 1;
+    std::vector<Game*> chunk;
+    for (size_t generated = 0; generated < options.count;) {
+        chunk.clear();
+        const size_t chunkCount = std::min(chunkSize, options.count - generated);
+        generated += chunkCount;
+        chunk.reserve(chunkCount);
+        for (size_t i = 0; i < chunkCount; ++i) {
+            std::string title;
+            for (size_t words = std::max<size_t>(titleLengths(generator), 1); words > 0; --words) {
+                title += model.titleWords[titleWords(generator)];
+                if (words > 1) {
+                    title += ' ';
+                }
+            }
+
+            std::vector<std::string> gameGenres;
+            const size_t genreCount = model.genres.empty() ? 0 : genreCounts(generator);
+            // Genres of a game are distinct, give up on a slot after a few collisions
+            for (size_t attempt = 0; gameGenres.size() < genreCount && attempt < genreCount * 4; ++attempt) {
+                const std::string& genre = model.genres[genres(generator)];
+                if (std::ranges::find(gameGenres.begin(), gameGenres.end(), genre) == gameGenres.end()) {
+                    gameGenres.push_back(genre);
+                }
+            }
+
+            const double score = model.scores.empty() ? 0.0 : model.scores[scores(generator)];
+            const int year = model.releaseYears.empty() ? 0 : model.releaseYears[years(generator)];
+            chunk.push_back(new Game(std::move(title), std::move(gameGenres), score,
+                                     model.platforms[platforms(generator)], nextId++, year));
+        }
+        applySortedness_(chunk, options, generator);
+        consumer(chunk);
+    }
+}
+
+std::vector<Game*> generateGames(const SynthModel& model, SynthOptions options) {
+    std::vector<Game*> games;
+    options.chunkSize = std::max<size_t>(options.count, 1);
+    generateGames(model, options, [&games](std::vector<Game*>& chunk) {
+        games = std::move(chunk);
+        chunk.clear();
+    });
+    return games;
+}
+
+void writeGameJson(std::ostream& out, const Game& game, const bool withPlatform) {
+    out << "{\"id\": " << game.get_id() << ", \"url\": \"https://www.mobygames.com/game/" << game.get_id()
+        << "/synthetic/\", \"title\": ";
+    writeJsonString_(out, game.get_title());
+    out << ", \"genres\": [";
+    const std::vector<std::string> genres = game.get_genres();
+    for (size_t i = 0; i < genres.size(); ++i) {
+        if (i > 0) {
+            out << ", ";
+        }
+        writeJsonString_(out, genres[i]);
+    }
+    out << "], \"release_year\": ";
+    if (game.get_release_year() == 0) {
+        out << "null";
+    } else {
+        out << game.get_release_year();
+    }
+    out << ", \"moby_score\": ";
+    if (game.get_score() == 0.0) {
+        out << "null";
+    } else {
+        out << game.get_score();
+    }
+    if (withPlatform) {
+        out << ", \"platform\": ";
+        writeJsonString_(out, game.get_platform());
+    }
+    out << '}';
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Game.hpp"
+
+/**
+ * @brief Distributions of the fields of a dataset, used to generate synthetic games
+ *
+ * Every distribution is a list of values with how often they appeared.
+ * Titles are modelled as a number of words drawn independently from the
+ * title vocabulary.
+ */
+struct SynthModel {
+    std::vector<std::string> titleWords;
+    std::vector<double> titleWordWeights;
+    std::vector<double> titleLengthWeights; // index = number of words
+    std::vector<std::string> genres;
+    std::vector<double> genreWeights;
+    std::vector<double> genreCountWeights; // index = number of genres
+    std::vector<double> scores;
+    std::vector<double> scoreWeights;
+    std::vector<std::string> platforms;
+    std::vector<double> platformWeights;
+    std::vector<int> releaseYears;
+    std::vector<double> releaseYearWeights;
+};
+
+enum class SynthOrder {
+    Title,
+    Score,
+    Genre,
+    Platform
+};
+
+/**
+ * @brief Knobs of the synthetic dataset
+ *
+ * skew reshapes every learned distribution: weights are raised to this power,
+ * so 1 keeps the real distributions, 0 makes them uniform and values above 1
+ * concentrate them on the most common values (more duplicate keys).
+ *
+ * sortedness is the fraction of games that are left in order after the games
+ * are sorted by sortOrder: 0 is a random order, 1 is fully sorted, and values
+ * in between displace a random (1 - sortedness) share of the games.
+ */
+struct SynthOptions {
+    size_t count = 0;
+    uint64_t seed = 0;
+    double skew = 1.0;
+    double sortedness = 0.0;
+    SynthOrder sortOrder = SynthOrder::Title;
+    // Games are generated and ordered in chunks of this many, so memory stays bounded for huge datasets
+    size_t chunkSize = 1'000'000;
+};
+
+/**
+ * @brief Learn the field distributions of a loaded dataset
+ *
+ * @param games The real games, usually from parseJsons()
+ */
+SynthModel learnSynthModel(const std::vector<Game*>& games);
+
+/**
+ * @brief Generate synthetic games in chunks
+ *
+ * @param model Learned distributions, see learnSynthModel()
+ * @param options Size, seed, skew and sortedness of the dataset
+ * @param consumer Called with every chunk of options.chunkSize games. It takes
+ * ownership of the games, which are only ordered within their chunk.
+ *
+ * The same model and options always produce the same games. Ids start at 1.
+ */
+void generateGames(const SynthModel& model, const SynthOptions& options,
+                   const std::function<void(std::vector<Game*>& chunk)>& consumer);
+
+/**
+ * @brief Generate a whole synthetic dataset in memory, ready to be sorted
+ *
+ * The dataset is generated as a single chunk, so sortedness applies to all of it.
+ */
+std::vector<Game*> generateGames(const SynthModel& model, SynthOptions options);
+
+/**
+ * @brief Write one game as a JSON object in the MobyGames schema
+ *
+ * @param out Stream to write to
+ * @param game Game to write
+ * @param withPlatform Add a "platform" field, needed for NDJSON files that mix platforms
+ */
+void writeGameJson(std::ostream& out, const Game& game, bool withPlatform);
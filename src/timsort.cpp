@@ -2,17 +2,20 @@
 #include <vector>
 
 #include "timsort.hpp"
+#include "instrument.hpp"
+#include "sortprogress.hpp"
 
 namespace ts {
-    // All instances of static_cast<long long> are fine, as our data will never be larger than 500,000 elements.
-    // long long can represent at least 9,223,372,036,854,775,807.
+    // All instances of static_cast<long long> are fine, a vector's size always fits in its signed difference_type.
+    // long long can represent at least 9,223,372,036,854,775,807, far beyond even 100 million synthetic games.
     void binaryInsertionSort(std::vector<Game*>& games, bool (*comparator)(const Game* lhs, const Game* rhs)) {
         for (size_t leftUnsorted = 1; leftUnsorted < games.size(); leftUnsorted++) {
             // The key is the first unsorted element
             Game* key = games[leftUnsorted];
 
-            // Search for the appropriate key location with binary search using std::lower_bound for sort stability
-            const size_t targetIndex = (std::lower_bound(games.begin(),
+            // Search for the appropriate key location with binary search. std::upper_bound places the key after
+            // the elements equal to it, which keeps the sort stable
+            const size_t targetIndex = (std::upper_bound(games.begin(),
                                                          games.begin() + static_cast<long long>(leftUnsorted), key,
                                                          comparator) - games.begin());
 
@@ -24,6 +27,10 @@ namespace ts {
 
             // Move the key to the correct position
             games[targetIndex] = key;
+            // The key is taken out and put back, every element between the two positions is shifted
+            instr::countMoves(leftUnsorted - targetIndex + 2);
+            // Progress is counted in elements inserted, see SortAlgorithm::work
+            progress::advance(1);
         }
     }
 
@@ -33,16 +40,20 @@ namespace ts {
         // While inside the bounds of the split vectors
         while (leftIndex < leftSlice.size() && rightIndex < rightSlice.size()) {
             // Compare element-by-element and overwrite the appropriate position in the main vector
-            if (comparator(leftSlice[leftIndex], rightSlice[rightIndex])) {
-                mainVector[main_index] = leftSlice[leftIndex];
-                leftIndex++;
-            } else {
+            // Ties go to the left slice, which keeps equal elements in their original order
+            if (comparator(rightSlice[rightIndex], leftSlice[leftIndex])) {
                 mainVector[main_index] = rightSlice[rightIndex];
                 ++rightIndex;
+            } else {
+                mainVector[main_index] = leftSlice[leftIndex];
+                leftIndex++;
             }
             ++main_index;
         }
 
+        // Every element of both slices is written to the main vector exactly once
+        instr::countMoves(leftSlice.size() + rightSlice.size());
+
         // Copy remaining elements of the vectors, if there are any
         while (leftIndex < leftSlice.size()) {
             mainVector[main_index] = leftSlice[leftIndex];
@@ -71,6 +82,8 @@ namespace ts {
             binaryInsertionSort(slice, comparator);
             // Use copy to quickly move the result back into the original vector
             std::ranges::copy(slice.begin(), slice.end(), games.begin() + static_cast<long long>(i));
+            // Copied into the slice and back
+            instr::countMoves(2 * slice.size());
         }
 
         // Start merging the vectors
@@ -90,6 +103,9 @@ namespace ts {
                     merge_(leftSlice, rightSlice, result, comparator);
                     // Use copy to quickly move the result back into the original vector
                     std::ranges::copy(result.begin(), result.end(), games.begin() + static_cast<long long>(left));
+                    // Copied into the slices and back, merge_ counts its own writes
+                    instr::countMoves(2 * result.size());
+                    progress::advance(result.size());
                 }
             }
         }
@@ -16,7 +16,7 @@ namespace ts {
      * positions of unsorted elements, the searching process is siginificantly
      * improved from a computational complexity of O(n) to O(log(n)).
      * This makes the sort reasonably fast on its own. Note that
-     * std::lower_bound is a C++ built-in implementation of binary search.
+     * std::upper_bound is a C++ built-in implementation of binary search.
      *
      * However, binary search does not improve the overall computational
      * computational complexity of the sorting algorithm,
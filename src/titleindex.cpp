@@ -0,0 +1,126 @@
+#include "titleindex.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <ranges>
+#include <stdexcept>
+
+TitleIndex::TitleIndex(const std::vector<Game*>& games) {
+    std::vector<std::string> folded(games.size());
+    for (size_t i = 0; i < games.size(); ++i) {
+        foldCase(games[i]->get_title(), folded[i]);
+    }
+    std::vector<size_t> order(games.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::ranges::stable_sort(order, {}, [&](const size_t game) -> const std::string& {
+        return folded[game];
+    });
+
+    keyStarts_.reserve(games.size() + 1);
+    games_.reserve(games.size());
+    for (const size_t game : order) {
+        keyStarts_.push_back(keys_.size());
+        keys_ += folded[game];
+        games_.push_back(games[game]);
+    }
+    keyStarts_.push_back(keys_.size());
+
+    // Bucket 0 holds the empty titles, bucket b + 1 the titles starting with byte b
+    size_t entry = 0;
+    for (size_t bucket = 0; bucket < firstByte_.size(); ++bucket) {
+        firstByte_[bucket] = entry;
+        while (entry < games_.size() &&
+               (key_(entry).empty() ? 0 : static_cast<unsigned char>(key_(entry).front()) + 1U) == bucket) {
+            ++entry;
+        }
+    }
+
+    byAddress_.reserve(games_.size());
+    for (size_t i = 0; i < games_.size(); ++i) {
+        byAddress_.emplace_back(games_[i], i);
+    }
+    std::ranges::sort(byAddress_);
+    setDisplayOrder(games);
+}
+
+size_t TitleIndex::size() const {
+    return games_.size();
+}
+
+TitleIndex::Range TitleIndex::findPrefix(const std::string_view prefix) const {
+    std::string folded;
+    foldCase(prefix, folded);
+    if (folded.empty()) {
+        return {0, games_.size()};
+    }
+    const auto bucket = static_cast<unsigned char>(folded.front()) + 1U;
+    const size_t first = firstByte_[bucket];
+    const size_t last = firstByte_[bucket + 1];
+    // Keys that start with the prefix sort right after the keys smaller than it
+    const auto entries = std::views::iota(first, last);
+    const auto matches = std::ranges::partition_point(entries, [&](const size_t entry) {
+        return key_(entry) < folded;
+    });
+    const auto end = std::ranges::partition_point(matches, entries.end(), [&](const size_t entry) {
+        return key_(entry).starts_with(folded);
+    });
+    return {first + static_cast<size_t>(matches - entries.begin()), first + static_cast<size_t>(end - entries.begin())};
+}
+
+const Game* TitleIndex::getGame(const size_t entry) const {
+    return games_.at(entry);
+}
+
+void TitleIndex::setDisplayOrder(const std::vector<Game*>& games) {
+    if (games.size() != games_.size()) {
+        throw std::invalid_argument("The display order has to hold the indexed games");
+    }
+    positions_.assign(games_.size(), 0);
+    for (size_t position = 0; position < games.size(); ++position) {
+        const auto found = std::ranges::lower_bound(byAddress_, games[position], {},
+                                                    &std::pair<const Game*, size_t>::first);
+        if (found == byAddress_.end() || found->first != games[position]) {
+            throw std::invalid_argument("The display order has to hold the indexed games");
+        }
+        positions_[found->second] = position;
+    }
+    blockMinima_.assign((games_.size() + BLOCK_ - 1) / BLOCK_, std::numeric_limits<size_t>::max());
+    for (size_t entry = 0; entry < positions_.size(); ++entry) {
+        blockMinima_[entry / BLOCK_] = std::min(blockMinima_[entry / BLOCK_], positions_[entry]);
+    }
+}
+
+std::optional<size_t> TitleIndex::findFirstDisplayed(const std::string_view prefix) const {
+    const auto [first, last] = findPrefix(prefix);
+    if (first == last) {
+        return std::nullopt;
+    }
+    return minimumPosition_(first, last);
+}
+
+void TitleIndex::foldCase(const std::string_view text, std::string& out) {
+    out.reserve(out.size() + text.size());
+    for (const char c : text) {
+        out += c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+}
+
+std::string_view TitleIndex::key_(const size_t entry) const {
+    return std::string_view(keys_).substr(keyStarts_[entry], keyStarts_[entry + 1] - keyStarts_[entry]);
+}
+
+size_t TitleIndex::minimumPosition_(size_t first, const size_t last) const {
+    size_t minimum = std::numeric_limits<size_t>::max();
+    // Single entries up to a block boundary, whole blocks, then single entries again
+    for (; first < last && first % BLOCK_ != 0; ++first) {
+        minimum = std::min(minimum, positions_[first]);
+    }
+    for (; first + BLOCK_ <= last; first += BLOCK_) {
+        minimum = std::min(minimum, blockMinima_[first / BLOCK_]);
+    }
+    for (; first < last; ++first) {
+        minimum = std::min(minimum, positions_[first]);
+    }
+    return minimum;
+}
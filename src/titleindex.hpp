@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Game.hpp"
+
+/**
+ * @brief Finds the games whose title starts with a prefix, ignoring ASCII case
+ *
+ * The titles are lowercased once and kept back to back in one pool, in title order, with
+ * the start of every first byte's range in a table. A prefix query is two binary searches
+ * within its first byte's range, each comparing at most the prefix's length per step, so
+ * a query over 400,000 titles costs a few microseconds whatever the number of matches.
+ *
+ * The matches of a prefix are a contiguous range in title order. For the main window's
+ * jump-to, setDisplayOrder() records where each game is currently displayed, and the
+ * minimum of every block of 256 entries, so the first displayed match is found without
+ * visiting every match.
+ */
+class TitleIndex {
+public:
+    // Entries [first, last) in title order
+    using Range = std::pair<size_t, size_t>;
+
+    // Indexes the titles of the games, which must outlive the index. The display order starts as given.
+    explicit TitleIndex(const std::vector<Game*>& games);
+
+    [[nodiscard("Getter")]] size_t size() const;
+
+    [[nodiscard("Getter")]] Range findPrefix(std::string_view prefix) const;
+
+    [[nodiscard("Getter")]] const Game* getGame(size_t entry) const;
+
+    // The order the games are displayed in now, the same games as the index was built from
+    void setDisplayOrder(const std::vector<Game*>& games);
+
+    // Display position of the first displayed game whose title starts with prefix
+    [[nodiscard("Getter")]] std::optional<size_t> findFirstDisplayed(std::string_view prefix) const;
+
+    // Lowercase ASCII letters, leave every other byte alone so UTF-8 titles still match themselves
+    static void foldCase(std::string_view text, std::string& out);
+
+private:
+    static constexpr size_t BLOCK_ = 256;
+
+    // Lowercased titles back to back in title order, entry i is keys_[keyStarts_[i], keyStarts_[i + 1])
+    std::string keys_;
+    std::vector<size_t> keyStarts_;
+    std::vector<const Game*> games_;
+    // Entries whose key starts with byte b are [firstByte_[b], firstByte_[b + 1]), empty keys come first
+    std::array<size_t, 258> firstByte_{};
+    // Game addresses in address order with their entries, to find a game's entry for setDisplayOrder()
+    std::vector<std::pair<const Game*, size_t>> byAddress_;
+    // Display position of every entry, and the smallest of each block of BLOCK_ entries
+    std::vector<size_t> positions_;
+    std::vector<size_t> blockMinima_;
+
+    [[nodiscard("Getter")]] std::string_view key_(size_t entry) const;
+
+    // Smallest display position of the entries [first, last)
+    [[nodiscard("Getter")]] size_t minimumPosition_(size_t first, size_t last) const;
+};
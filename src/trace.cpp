@@ -0,0 +1,167 @@
+#include "trace.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+    // Spans each thread keeps, about 5 MiB per traced thread. Older spans are overwritten first
+    constexpr size_t RING_CAPACITY_ = 1 << 16;
+
+    struct Event_ {
+        const char* name;
+        std::string detail;
+        long long start;
+        long long duration;
+    };
+
+    // Spans of one thread. The thread appends under the mutex, which is only contended while finish() writes
+    struct ThreadBuffer_ {
+        std::mutex mutex;
+        std::vector<Event_> events;
+        size_t next = 0;
+        size_t dropped = 0;
+        int threadId = 0;
+    };
+
+    std::atomic<bool> enabled_{false};
+    std::mutex buffersMutex_;
+    // Buffers outlive their threads, so spans of finished threads still end up in the trace
+    std::vector<std::shared_ptr<ThreadBuffer_>> buffers_;
+    std::string path_;
+
+    long long nowNanoseconds_() {
+        static const auto epoch = std::chrono::steady_clock::now();
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+    }
+
+    ThreadBuffer_& threadBuffer_() {
+        static thread_local std::shared_ptr<ThreadBuffer_> buffer;
+        if (!buffer) {
+            buffer = std::make_shared<ThreadBuffer_>();
+            buffer->events.reserve(RING_CAPACITY_);
+            const std::scoped_lock lock(buffersMutex_);
+            buffer->threadId = static_cast<int>(buffers_.size()) + 1;
+            buffers_.push_back(buffer);
+        }
+        return *buffer;
+    }
+
+    void record_(const char* name, std::string&& detail, const long long start, const long long duration) {
+        ThreadBuffer_& buffer = threadBuffer_();
+        const std::scoped_lock lock(buffer.mutex);
+        if (buffer.events.size() < RING_CAPACITY_) {
+            buffer.events.push_back({name, std::move(detail), start, duration});
+            return;
+        }
+        buffer.events[buffer.next] = {name, std::move(detail), start, duration};
+        buffer.next = (buffer.next + 1) % RING_CAPACITY_;
+        ++buffer.dropped;
+    }
+
+    std::string escape_(const std::string_view text) {
+        std::string escaped;
+        escaped.reserve(text.size());
+        for (const unsigned char c : text) {
+            if (c == '"' || c == '\\') {
+                escaped += '\\';
+                escaped += static_cast<char>(c);
+            } else if (c < 0x20) {
+                char code[8];
+                std::snprintf(code, sizeof(code), "\\u%04x", c);
+                escaped += code;
+            } else {
+                escaped += static_cast<char>(c);
+            }
+        }
+        return escaped;
+    }
+
+    // Chrome traces count in microseconds, fractions keep nanosecond resolution
+    void writeMicroseconds_(std::ostream& out, const long long nanoseconds) {
+        char number[32];
+        std::snprintf(number, sizeof(number), "%.3f", static_cast<double>(nanoseconds) / 1000.0);
+        out << number;
+    }
+}
+
+namespace trace {
+    void start(const std::string& path) {
+        // Fail now rather than after the run, when finish() has nowhere to report it but stderr
+        if (!std::ofstream(path, std::ios::app).is_open()) {
+            throw std::runtime_error("Failed to open trace file at " + path);
+        }
+        const std::scoped_lock lock(buffersMutex_);
+        path_ = path;
+        nowNanoseconds_();
+        enabled_.store(true, std::memory_order_relaxed);
+    }
+
+    bool enabled() {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    void finish() {
+        if (!enabled_.exchange(false)) {
+            return;
+        }
+        const std::scoped_lock lock(buffersMutex_);
+        std::ofstream file(path_);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open trace file at " + path_);
+        }
+        file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+        bool first = true;
+        size_t dropped = 0;
+        for (const auto& buffer : buffers_) {
+            const std::scoped_lock bufferLock(buffer->mutex);
+            dropped += buffer->dropped;
+            file << (first ? "" : ",\n") << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": "
+                 << buffer->threadId << ", \"args\": {\"name\": \""
+                 << (buffer->threadId == 1 ? "main" : "worker " + std::to_string(buffer->threadId)) << "\"}}";
+            first = false;
+            // Oldest first: once the ring wrapped, the oldest span is the next one to be overwritten
+            for (size_t i = 0; i < buffer->events.size(); ++i) {
+                const Event_& event = buffer->events[(buffer->next + i) % buffer->events.size()];
+                file << ",\n{\"name\": \"" << escape_(event.name) << "\", \"cat\": \"gamesort\", \"ph\": \"X\", "
+                     << "\"pid\": 1, \"tid\": " << buffer->threadId << ", \"ts\": ";
+                writeMicroseconds_(file, event.start);
+                file << ", \"dur\": ";
+                writeMicroseconds_(file, event.duration);
+                if (!event.detail.empty()) {
+                    file << ", \"args\": {\"detail\": \"" << escape_(event.detail) << "\"}";
+                }
+                file << '}';
+            }
+            buffer->events.clear();
+            buffer->next = 0;
+            buffer->dropped = 0;
+        }
+        file << "\n]}\n";
+        fprintf(stderr, "trace written to %s", path_.c_str());
+        if (dropped > 0) {
+            fprintf(stderr, ", %zu oldest spans were dropped", dropped);
+        }
+        fprintf(stderr, "\n");
+    }
+
+    Span::Span(const char* name, const std::string_view detail) : name_(name), active_(enabled()) {
+        if (active_) {
+            detail_ = detail;
+            start_ = nowNanoseconds_();
+        }
+    }
+
+    void Span::end() {
+        if (!active_) {
+            return;
+        }
+        active_ = false;
+        record_(name_, std::move(detail_), start_, nowNanoseconds_() - start_);
+    }
+}
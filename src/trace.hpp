@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+/*
+ * Timeline tracing in the Chrome trace event format, viewable in chrome://tracing or https://ui.perfetto.dev.
+ *
+ * Tracing is off until start() is called, and a span then costs one relaxed atomic load. While tracing, every
+ * thread records its finished spans into its own ring buffer, which keeps the newest spans when it fills up.
+ */
+namespace trace {
+    /**
+     * @brief Start recording spans
+     *
+     * @param path File the trace is written to by finish()
+     *
+     * Throws std::runtime_error if the file can't be opened for writing.
+     */
+    void start(const std::string& path);
+
+    // True between start() and finish()
+    bool enabled();
+
+    /**
+     * @brief Stop recording and write every thread's spans to the path given to start()
+     *
+     * Does nothing if tracing wasn't started. Throws std::runtime_error if the file can't be written.
+     */
+    void finish();
+
+    /**
+     * @brief A named span of time on the current thread, from construction until end() or destruction
+     *
+     * @param name Static string shown as the span's name, e.g. "load parse"
+     * @param detail Optional argument shown with the span, e.g. a file name. Only copied while tracing.
+     */
+    class Span {
+    public:
+        explicit Span(const char* name, std::string_view detail = {});
+
+        ~Span() {
+            end();
+        }
+
+        Span(const Span&) = delete;
+
+        Span& operator=(const Span&) = delete;
+
+        void end();
+
+    private:
+        const char* name_;
+        std::string detail_;
+        long long start_ = 0;
+        bool active_;
+    };
+}
@@ -0,0 +1,317 @@
+// GameSort-bench: times every sort algorithm with every comparator, without a display
+//
+// Usage: GameSort-bench [--ndjson PATH | --synthetic N] [--seed S] [--trials N] [--warmups N]
+//                       [--quadratic-limit N] [--algorithms a,b,...] [--fields f,g,...]
+//                       [--orders o,p,...] [--perturb PERCENT] [--json PATH] [--trace PATH] [--history DIR]
+//                       [--composite ORDER] [--page ROWS]
+//        GameSort-bench --compare BASELINE.json CANDIDATE.json [--threshold PERCENT]
+//
+// Every algorithm and field is run on every input order: random, sorted, reversed, sorted_other, few_unique,
+// organ_pipe and perturbed (PERCENT % of a sorted input displaced, 5 by default). Inputs are reproducible from
+// the seed. --composite also times an order on several fields such as "platform,-rating,title" (see
+// parseSortKeys) on the random input, once with compositeSort's packed keys and once with std::stable_sort
+// calling compositeLess. --page also times getting only the first ROWS games of every field from the random input,
+// with IncrementalSort and with topK, against which the full sorts' time to the first page can be compared.
+//
+// The dataset is the real platform jsons unless an NDJSON file or a synthetic size is given. Results are printed
+// as a table of nanoseconds per element, and written as JSON with every raw sample when --json is given
+// ("-" writes the JSON to stdout instead of the table). Where Linux hardware counters are available, IPC and cache,
+// branch and dTLB misses per element are reported too. --trace writes a Chrome trace of loading and every trial.
+//
+// The JSON records the commit, compiler, flags and CPU it was measured with. --history also writes it to DIR under
+// a name keyed by those (see historyFileName). --compare reads two such files instead of running anything, prints
+// the change of every benchmark they share with a confidence interval and a Mann-Whitney p-value, and exits with 1
+// if any benchmark is significantly slower by more than PERCENT % (5 by default). It exits with 2 instead when the
+// runs have too few trials for any benchmark to be significant after correcting for the number of benchmarks.
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "../src/allocprofile.hpp"
+#include "../src/benchhistory.hpp"
+#include "../src/benchmark.hpp"
+#include "../src/compositesort.hpp"
+#include "../src/footprint.hpp"
+#include "../src/inputorder.hpp"
+#include "../src/loader.hpp"
+#include "../src/partialsort.hpp"
+#include "../src/synth.hpp"
+#include "../src/trace.hpp"
+
+namespace {
+    // Family-wise significance level of --compare
+    constexpr double ALPHA_ = 0.05;
+
+    void printUsage_() {
+        std::cerr << "usage: GameSort-bench [--ndjson PATH | --synthetic N] [--seed S] [--trials N] [--warmups N]\n"
+                     "                      [--quadratic-limit N] [--algorithms a,b,...] [--fields f,g,...]\n"
+                     "                      [--orders o,p,...] [--perturb PERCENT] [--json PATH] [--trace PATH]\n"
+                     "                      [--history DIR] [--composite ORDER] [--page ROWS]\n"
+                     "       GameSort-bench --compare BASELINE.json CANDIDATE.json [--threshold PERCENT]\n";
+    }
+
+    // True if name is in the comma separated list, or the list is empty
+    bool isSelected_(const std::string& list, const std::string& name) {
+        if (list.empty()) {
+            return true;
+        }
+        std::stringstream stream(list);
+        std::string item;
+        while (std::getline(stream, item, ',')) {
+            if (item == name) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // --compare: exit code 1 if any benchmark regressed past the threshold
+    int compare_(const std::string& baselinePath, const std::string& candidatePath, const double thresholdPercent) {
+        BuildInfo baselineBuild;
+        BuildInfo candidateBuild;
+        const std::vector<BenchResult> baseline = readBenchJson(baselinePath, baselineBuild);
+        const std::vector<BenchResult> candidate = readBenchJson(candidatePath, candidateBuild);
+        std::cout << "baseline:  " << baselineBuild.commit << ", " << baselineBuild.compiler << '\n'
+                  << "candidate: " << candidateBuild.commit << ", " << candidateBuild.compiler << '\n';
+        if (baselineBuild.cpu != candidateBuild.cpu || baselineBuild.compiler != candidateBuild.compiler ||
+            baselineBuild.flags != candidateBuild.flags) {
+            std::cerr << "warning: the runs differ in CPU, compiler or flags, differences aren't only the code's\n";
+        }
+
+        const std::vector<BenchComparison> comparisons = compareBenchResults(baseline, candidate,
+                                                                             thresholdPercent / 100.0, ALPHA_);
+        if (!comparisons.empty() && smallestAdjustedPValue(comparisons) >= ALPHA_) {
+            // The fewest trials per run with which the same benchmarks could show a regression
+            std::vector<BenchComparison> needed = comparisons;
+            size_t trials = 2;
+            for (;; ++trials) {
+                for (auto& comparison : needed) {
+                    comparison.baselineTrials = trials;
+                    comparison.candidateTrials = trials;
+                }
+                if (smallestAdjustedPValue(needed) < ALPHA_) {
+                    break;
+                }
+            }
+            std::cerr << "error: with these trial counts none of the " << comparisons.size()
+                      << " benchmarks can be significantly slower after correcting for their number,\n"
+                      << "run both with --trials " << trials << " or more, or compare fewer benchmarks\n";
+            return 2;
+        }
+        printBenchComparison(std::cout, comparisons, ALPHA_);
+        const auto regressions = std::ranges::count_if(comparisons, [](const BenchComparison& comparison) {
+            return comparison.regression;
+        });
+        std::cout << comparisons.size() << " benchmarks compared, " << regressions << " regressed by more than "
+                  << thresholdPercent << " %\n";
+        return regressions == 0 ? 0 : 1;
+    }
+}
+
+int main(const int argc, char* argv[]) {
+    BenchOptions options;
+    std::string ndjsonPath;
+    size_t syntheticCount = 0;
+    uint64_t seed = 1;
+    std::string algorithms;
+    std::string fields;
+    std::string orders;
+    double perturbPercent = 5.0;
+    std::string jsonPath;
+    std::string historyDirectory;
+    std::string baselinePath;
+    std::string candidatePath;
+    double thresholdPercent = 5.0;
+    std::string composite;
+    size_t pageRows = 0;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--compare" && i + 2 < argc) {
+            baselinePath = argv[++i];
+            candidatePath = argv[++i];
+            continue;
+        }
+        if (i + 1 >= argc) {
+            printUsage_();
+            return 1;
+        }
+        const std::string value = argv[++i];
+        if (arg == "--ndjson") {
+            ndjsonPath = value;
+        } else if (arg == "--synthetic") {
+            syntheticCount = std::stoull(value);
+        } else if (arg == "--seed") {
+            seed = std::stoull(value);
+        } else if (arg == "--trials") {
+            options.trials = std::max<size_t>(std::stoull(value), 1);
+        } else if (arg == "--warmups") {
+            options.warmups = std::stoull(value);
+        } else if (arg == "--quadratic-limit") {
+            options.quadraticLimit = std::stoull(value);
+        } else if (arg == "--algorithms") {
+            algorithms = value;
+        } else if (arg == "--fields") {
+            fields = value;
+        } else if (arg == "--orders") {
+            orders = value;
+        } else if (arg == "--perturb") {
+            perturbPercent = std::stod(value);
+        } else if (arg == "--json") {
+            jsonPath = value;
+        } else if (arg == "--trace") {
+            try {
+                trace::start(value);
+            } catch (const std::runtime_error& error) {
+                std::cerr << error.what() << '\n';
+                return 1;
+            }
+        } else if (arg == "--history") {
+            historyDirectory = value;
+        } else if (arg == "--threshold") {
+            thresholdPercent = std::stod(value);
+        } else if (arg == "--composite") {
+            composite = value;
+        } else if (arg == "--page") {
+            pageRows = std::stoull(value);
+        } else {
+            printUsage_();
+            return 1;
+        }
+    }
+
+    if (!baselinePath.empty()) {
+        return compare_(baselinePath, candidatePath, thresholdPercent);
+    }
+
+    LoadStats loadStats;
+    std::vector<Game*> games = ndjsonPath.empty() ? parseJsons(&loadStats) : parseNdjson(ndjsonPath, &loadStats);
+    std::string dataset = ndjsonPath.empty() ? "real" : ndjsonPath;
+    if (syntheticCount > 0) {
+        const SynthModel model = learnSynthModel(games);
+        for (const Game* game : games) {
+            delete game;
+        }
+        SynthOptions synthOptions;
+        synthOptions.count = syntheticCount;
+        synthOptions.seed = seed;
+        games = generateGames(model, synthOptions);
+        dataset = "synthetic";
+    }
+
+    // Measured before the inputs are arranged, so only the games vector itself is counted
+    const footprint::MemoryFootprint memory = footprint::measureFootprint(games, {&games});
+
+    // Every algorithm starts from the same arranged input for a field and order
+    std::vector<BenchResult> results;
+    for (const auto& comparator : SORT_COMPARATORS) {
+        if (!isSelected_(fields, comparator.name)) {
+            continue;
+        }
+        for (const InputOrder order : INPUT_ORDERS) {
+            if (!isSelected_(orders, inputOrderName(order))) {
+                continue;
+            }
+            const ArrangedInput arranged = arrangeInput(games, order, comparator, seed, perturbPercent / 100.0);
+            const std::vector<Game*>& input = arranged.games;
+            for (const auto& algorithm : SORT_ALGORITHMS) {
+                if (isSelected_(algorithms, algorithm.name)) {
+                    results.push_back(runSortBenchmark(algorithm, comparator, input, inputOrderName(order),
+                                                       options));
+                    std::cerr << '.';
+                }
+            }
+            if (pageRows > 0 && order == InputOrder::Random) {
+                results.push_back(runCustomSortBenchmark("incremental_page", comparator.name, input, "random",
+                                                         options, [&](std::vector<Game*>& sorted) {
+                                                             IncrementalSort(sorted, comparator.compare)
+                                                                 .sortPrefix(pageRows);
+                                                         }));
+                results.push_back(runCustomSortBenchmark("top_k", comparator.name, input, "random", options,
+                                                         [&](std::vector<Game*>& sorted) {
+                                                             sorted = topK(sorted, pageRows, comparator.compare);
+                                                         }));
+                std::cerr << "..";
+            }
+        }
+    }
+    if (!composite.empty() && isSelected_(orders, inputOrderName(InputOrder::Random))) {
+        const std::vector<SortKey> keys = parseSortKeys(composite);
+        const ArrangedInput arranged = arrangeInput(games, InputOrder::Random, SORT_COMPARATORS[0], seed,
+                                                    perturbPercent / 100.0);
+        const std::vector<Game*>& input = arranged.games;
+        const std::string name = sortKeysName(keys);
+        results.push_back(runCustomSortBenchmark("packed_key_radix", name, input, "random", options,
+                                                 [&](std::vector<Game*>& sorted) {
+                                                     compositeSort(sorted, keys);
+                                                 }));
+        results.push_back(runCustomSortBenchmark("comparator_chain", name, input, "random", options,
+                                                 [&](std::vector<Game*>& sorted) {
+                                                     std::ranges::stable_sort(sorted, [&](const Game* lhs,
+                                                                                          const Game* rhs) {
+                                                         return compositeLess(keys, lhs, rhs);
+                                                     });
+                                                 }));
+        std::cerr << "..";
+    }
+    std::cerr << '\n';
+
+    if (jsonPath != "-") {
+        printBenchTable(std::cout, results);
+    }
+    if constexpr (heap::ENABLED) {
+        std::cerr << "allocations by phase:\n";
+        heap::printReport(std::cerr);
+    }
+    if (!jsonPath.empty() || !historyDirectory.empty()) {
+        std::ostringstream metadata;
+        metadata << "\"build\": " << buildInfoJson(currentBuildInfo()) << ",\n  \"dataset\": \""
+                 << escapeJson(dataset) << "\", \"elements\": " << games.size() << ", \"seed\": " << seed
+                 << ", \"perturb_percent\": " << perturbPercent << ", \"warmups\": "
+                 << options.warmups << ", \"trials\": " << options.trials << ",\n  \"load\": {\"bytes\": "
+                 << loadStats.bytes << ", \"records\": " << loadStats.records << ", \"read_ns\": "
+                 << loadStats.read.count() << ", \"parse_ns\": " << loadStats.parse.count() << ", \"build_ns\": "
+                 << loadStats.build.count() << ", \"filter_ns\": " << loadStats.filter.count()
+                 << ", \"dedup_ns\": " << loadStats.dedup.count();
+        if (loadStats.parseEvents.available != 0) {
+            metadata << ", \"events\": {\"read\": " << perf::countersJson(loadStats.readEvents)
+                     << ", \"parse\": " << perf::countersJson(loadStats.parseEvents) << ", \"build\": "
+                     << perf::countersJson(loadStats.buildEvents) << ", \"filter\": "
+                     << perf::countersJson(loadStats.filterEvents) << ", \"dedup\": "
+                     << perf::countersJson(loadStats.dedupEvents) << '}';
+        }
+        metadata << "},\n  \"memory\": " << footprint::footprintJson(memory);
+        if constexpr (heap::ENABLED) {
+            metadata << ",\n  \"allocations\": " << heap::reportJson();
+        }
+        std::vector<std::string> paths;
+        if (!jsonPath.empty() && jsonPath != "-") {
+            paths.push_back(jsonPath);
+        }
+        if (!historyDirectory.empty()) {
+            std::filesystem::create_directories(historyDirectory);
+            paths.push_back((std::filesystem::path(historyDirectory) / historyFileName(currentBuildInfo())).string());
+        }
+        if (jsonPath == "-") {
+            writeBenchJson(std::cout, results, metadata.str());
+        }
+        for (const auto& path : paths) {
+            std::ofstream file(path);
+            if (!file.is_open()) {
+                std::cerr << "Failed to open " << path << '\n';
+                return 1;
+            }
+            writeBenchJson(file, results, metadata.str());
+        }
+    }
+
+    for (const Game* game : games) {
+        delete game;
+    }
+    trace::finish();
+    return 0;
+}
@@ -0,0 +1,65 @@
+// GameSort-fuzz: libFuzzer entry point that checks every sort on inputs decoded from the fuzzer's bytes
+//
+// Build with Clang and -DGAMESORT_BUILD_FUZZER=ON, then run e.g. ./GameSort-fuzz -max_len=4096 corpus/
+//
+// The first two bytes pick the algorithm and comparator. Every following group of four bytes is one element:
+// either a new game built from the bytes, or another reference to a game that is already in the input. Fields are
+// drawn from small sets, so the fuzzer reaches ties, empty genres, genre prefixes and case-only platform
+// differences quickly. Any problem found by checkSort() aborts with a description.
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include "../src/sortcheck.hpp"
+
+namespace {
+    const std::array<const char*, 4> TITLES_ = {"", "Doom", "doom", "Quest"};
+    const std::array<const char*, 4> GENRES_ = {"Action", "Adventure", "RPG", "Strategy"};
+    const std::array<const char*, 4> PLATFORMS_ = {"PC", "pc", "Switch", "Xbox"};
+
+    std::unique_ptr<Game> decodeGame_(const uint8_t* bytes, const uint64_t id) {
+        std::vector<std::string> genres;
+        // Low nibble: which genres, high bit: whether they're kept in the fixed order, which makes prefixes likely
+        for (size_t i = 0; i < GENRES_.size(); ++i) {
+            if ((bytes[2] >> i) & 1) {
+                genres.emplace_back(GENRES_[(bytes[2] & 0x80) != 0 ? i : (i + bytes[1]) % GENRES_.size()]);
+            }
+        }
+        return std::make_unique<Game>(TITLES_[bytes[0] % TITLES_.size()], std::move(genres),
+                                      static_cast<double>(bytes[1] % 21) / 2.0,
+                                      PLATFORMS_[(bytes[0] >> 2) % PLATFORMS_.size()], bytes[3] % 4 == 0 ? 0 : id);
+    }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, const size_t size) {
+    if (size < 2) {
+        return 0;
+    }
+    const SortAlgorithm& algorithm = SORT_ALGORITHMS[data[0] % SORT_ALGORITHMS.size()];
+    const SortComparator& comparator = SORT_COMPARATORS[data[1] % SORT_COMPARATORS.size()];
+
+    std::vector<std::unique_ptr<Game>> games;
+    std::vector<Game*> input;
+    for (size_t offset = 2; offset + 4 <= size; offset += 4) {
+        const uint8_t* bytes = data + offset;
+        // Odd last byte: repeat a game that's already in the input
+        if ((bytes[3] & 1) != 0 && !input.empty()) {
+            input.push_back(input[bytes[3] / 2 % input.size()]);
+            continue;
+        }
+        games.push_back(decodeGame_(bytes, offset));
+        input.push_back(games.back().get());
+    }
+
+    const std::string error = checkSort(algorithm, comparator, input);
+    if (!error.empty()) {
+        std::fprintf(stderr, "%s by %s, %zu games: %s\n", algorithm.name, comparator.name, input.size(),
+                     error.c_str());
+        std::abort();
+    }
+    return 0;
+}
@@ -0,0 +1,146 @@
+// GameSort-gen: writes synthetic platform datasets for scale testing
+//
+// Usage: GameSort-gen --count N [--seed S] [--skew X] [--sortedness P] [--order title|score|genre|platform]
+//                     [--format json|ndjson] [--out PATH] [--learn-from NDJSON]
+//
+// The field distributions are learned from the real platform jsons (or an NDJSON file) and games are streamed
+// out in chunks, so datasets far larger than memory can be written. json writes one array file per platform into
+// the directory PATH, like games/platforms/jsons/. ndjson writes one record per line to PATH, or stdout for "-".
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "../src/loader.hpp"
+#include "../src/synth.hpp"
+
+namespace {
+    SynthOrder parseOrder_(const std::string& order) {
+        if (order == "score" || order == "rating") {
+            return SynthOrder::Score;
+        }
+        if (order == "genre") {
+            return SynthOrder::Genre;
+        }
+        if (order == "platform") {
+            return SynthOrder::Platform;
+        }
+        return SynthOrder::Title;
+    }
+
+    void printUsage_() {
+        std::cerr << "usage: GameSort-gen --count N [--seed S] [--skew X] [--sortedness P]\n"
+                     "                    [--order title|score|genre|platform] [--format json|ndjson]\n"
+                     "                    [--out PATH] [--learn-from NDJSON]\n";
+    }
+
+    // Streams games into one JSON array file per platform
+    class PlatformFiles_ {
+    public:
+        explicit PlatformFiles_(std::filesystem::path directory) : directory_(std::move(directory)) {
+            std::filesystem::create_directories(directory_);
+        }
+
+        void write(const Game& game) {
+            auto [iter, inserted] = files_.try_emplace(game.get_platform());
+            if (inserted) {
+                iter->second = std::make_unique<std::ofstream>(directory_ / (game.get_platform() + ".json"),
+                                                               std::ios::binary);
+                *iter->second << '[';
+            } else {
+                *iter->second << ", ";
+            }
+            writeGameJson(*iter->second, game, false);
+        }
+
+        ~PlatformFiles_() {
+            for (auto& [platform, file] : files_) {
+                *file << "]";
+            }
+        }
+
+    private:
+        std::filesystem::path directory_;
+        std::map<std::string, std::unique_ptr<std::ofstream>> files_;
+    };
+}
+
+int main(const int argc, char* argv[]) {
+    SynthOptions options;
+    std::string format = "ndjson";
+    std::string out = "-";
+    std::string learnFrom;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            printUsage_();
+            return 1;
+        }
+        const std::string value = argv[++i];
+        if (arg == "--count") {
+            options.count = std::stoull(value);
+        } else if (arg == "--seed") {
+            options.seed = std::stoull(value);
+        } else if (arg == "--skew") {
+            options.skew = std::stod(value);
+        } else if (arg == "--sortedness") {
+            options.sortedness = std::stod(value);
+        } else if (arg == "--order") {
+            options.sortOrder = parseOrder_(value);
+        } else if (arg == "--format") {
+            format = value;
+        } else if (arg == "--out") {
+            out = value;
+        } else if (arg == "--learn-from") {
+            learnFrom = value;
+        } else {
+            printUsage_();
+            return 1;
+        }
+    }
+    if (options.count == 0 || (format != "json" && format != "ndjson") || (format == "json" && out == "-")) {
+        printUsage_();
+        return 1;
+    }
+
+    // Learn from the real dataset, then free it before generating
+    std::vector<Game*> realGames = learnFrom.empty() ? parseJsons() : parseNdjson(learnFrom);
+    const SynthModel model = learnSynthModel(realGames);
+    for (const Game* game : realGames) {
+        delete game;
+    }
+    realGames.clear();
+
+    if (format == "json") {
+        PlatformFiles_ files(out);
+        generateGames(model, options, [&files](std::vector<Game*>& chunk) {
+            for (const Game* game : chunk) {
+                files.write(*game);
+                delete game;
+            }
+        });
+    } else {
+        std::ofstream file;
+        if (out != "-") {
+            file.open(out, std::ios::binary);
+            if (!file.is_open()) {
+                std::cerr << "Failed to open " << out << '\n';
+                return 1;
+            }
+        }
+        std::ostream& stream = out == "-" ? std::cout : file;
+        generateGames(model, options, [&stream](std::vector<Game*>& chunk) {
+            for (const Game* game : chunk) {
+                writeGameJson(stream, *game, true);
+                stream << '\n';
+                delete game;
+            }
+        });
+    }
+    std::cerr << "wrote " << options.count << " games\n";
+    return 0;
+}
@@ -0,0 +1,193 @@
+// GameSort-verify: checks every sort algorithm against std::stable_sort on randomized and adversarial inputs
+//
+// Usage: GameSort-verify [--seed S] [--rounds N] [--large N]
+//
+// Every algorithm is run with every comparator on every game pool (see makeGamePool), every input order and a
+// range of sizes around the sorts' internal boundaries. Each result must be a permutation of its input, in order,
+// and equal to std::stable_sort's result. The comparators are also checked for being strict weak orderings.
+// compositeSort is checked the same way with a few orders on several fields, and IncrementalSort and topK with
+// prefixes of every size. dedupGames is checked on copies of every pool whose ids collide, including its
+// cross-platform group table.
+// A final pass sorts --large games (200,000 by default) with the O(n log n) algorithms.
+// GameSort-bench's regression gate is checked to flag a clear slowdown with the default number of trials.
+//
+// Exits with 1 if anything failed, so it can gate changes to the sorts.
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <string>
+
+#include "../src/benchhistory.hpp"
+#include "../src/inputorder.hpp"
+#include "../src/sortcheck.hpp"
+
+namespace {
+    // Empty, tiny, and either side of timsort's 512 element runs and their merges
+    constexpr std::array<size_t, 12> SIZES_ = {0, 1, 2, 3, 7, 64, 511, 512, 513, 1024, 1025, 2049};
+    // Orders on several fields for compositeSort, covering every field in both directions
+    constexpr std::array<const char*, 4> COMPOSITE_ORDERS_ = {
+        "platform,-rating,title", "-genre,year,-id", "rating,-platform,-title", "-title,genre"
+    };
+    // Failures printed before the rest are only counted
+    constexpr size_t MAX_REPORTED_ = 20;
+
+    struct Tally_ {
+        size_t checks = 0;
+        size_t failures = 0;
+
+        void record(const std::string& error, const std::string& context) {
+            ++checks;
+            if (error.empty()) {
+                return;
+            }
+            if (++failures <= MAX_REPORTED_) {
+                std::cerr << "FAIL " << context << ": " << error << '\n';
+            }
+        }
+    };
+
+    // Every other benchmark twice as slow in the candidate run, as many benchmarks as a default GameSort-bench run
+    std::string checkRegressionGate_(std::mt19937_64& generator) {
+        const size_t benchmarks = SORT_ALGORITHMS.size() * SORT_COMPARATORS.size() * INPUT_ORDERS.size();
+        std::normal_distribution<double> noise(100.0, 2.0);
+        std::vector<BenchResult> baseline;
+        std::vector<BenchResult> candidate;
+        for (size_t i = 0; i < benchmarks; ++i) {
+            BenchResult result;
+            result.algorithm = "algorithm" + std::to_string(i);
+            result.comparator = "title";
+            result.input = "random";
+            result.elements = 1000;
+            result.samples.resize(BenchOptions().trials);
+            std::ranges::generate(result.samples, [&] {
+                return noise(generator);
+            });
+            summarizeBenchResult(result);
+            baseline.push_back(result);
+            std::ranges::generate(result.samples, [&] {
+                return noise(generator) * (i % 2 == 0 ? 2.0 : 1.0);
+            });
+            summarizeBenchResult(result);
+            candidate.push_back(result);
+        }
+
+        const std::vector<BenchComparison> comparisons = compareBenchResults(baseline, candidate, 0.05);
+        if (comparisons.size() != benchmarks) {
+            return std::to_string(comparisons.size()) + " of " + std::to_string(benchmarks) + " benchmarks compared";
+        }
+        if (smallestAdjustedPValue(comparisons) >= 0.05) {
+            return "the default trials can't reach significance with " + std::to_string(benchmarks) + " benchmarks";
+        }
+        for (size_t i = 0; i < comparisons.size(); ++i) {
+            if (comparisons[i].regression != (i % 2 == 0)) {
+                return comparisons[i].name + (comparisons[i].regression ? " flagged without a slowdown"
+                                                                        : " not flagged despite a 2x slowdown");
+            }
+        }
+        return "";
+    }
+
+    void deleteGames_(const std::vector<Game*>& games) {
+        for (const Game* game : games) {
+            delete game;
+        }
+    }
+}
+
+int main(const int argc, char* argv[]) {
+    uint64_t seed = 1;
+    size_t rounds = 2;
+    size_t largeSize = 200'000;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const std::string arg = argv[i];
+        if (arg == "--seed") {
+            seed = std::stoull(argv[i + 1]);
+        } else if (arg == "--rounds") {
+            rounds = std::stoull(argv[i + 1]);
+        } else if (arg == "--large") {
+            largeSize = std::stoull(argv[i + 1]);
+        } else {
+            std::cerr << "usage: GameSort-verify [--seed S] [--rounds N] [--large N]\n";
+            return 1;
+        }
+    }
+
+    Tally_ tally;
+    std::mt19937_64 generator(seed);
+    for (size_t round = 0; round < rounds; ++round) {
+        for (const GamePool pool : GAME_POOLS) {
+            const std::vector<Game*> comparatorGames = makeGamePool(pool, 256, generator);
+            for (const auto& comparator : SORT_COMPARATORS) {
+                tally.record(checkComparator(comparator, comparatorGames, 20'000, generator),
+                             std::string(comparator.name) + " comparator on " + gamePoolName(pool));
+            }
+            deleteGames_(comparatorGames);
+
+            for (const size_t size : SIZES_) {
+                const std::vector<Game*> games = makeGamePool(pool, size, generator);
+                for (const auto& comparator : SORT_COMPARATORS) {
+                    for (const InputOrder order : INPUT_ORDERS) {
+                        const ArrangedInput arranged = arrangeInput(games, order, comparator, generator());
+                        const std::vector<Game*>& input = arranged.games;
+                        for (const auto& algorithm : SORT_ALGORITHMS) {
+                            tally.record(checkSort(algorithm, comparator, input),
+                                         std::string(algorithm.name) + ' ' + comparator.name + ' ' +
+                                         inputOrderName(order) + ' ' + gamePoolName(pool) + " n=" +
+                                         std::to_string(size));
+                        }
+                        // A page of the main window, and everything
+                        for (const size_t count : {size_t{25}, size}) {
+                            tally.record(checkPartialSort(comparator, input, count),
+                                         std::string("partial sort of ") + std::to_string(count) + ' ' +
+                                         comparator.name + ' ' + inputOrderName(order) + ' ' +
+                                         gamePoolName(pool) + " n=" + std::to_string(size));
+                        }
+                    }
+                }
+                for (const char* composite : COMPOSITE_ORDERS_) {
+                    tally.record(checkCompositeSort(parseSortKeys(composite), games),
+                                 std::string("compositeSort ") + composite + ' ' + gamePoolName(pool) + " n=" +
+                                 std::to_string(size));
+                }
+                // A third as many ids as games, so ids repeat across platforms and id 0 groups by title
+                tally.record(checkGameGroups(games, size / 3 + 1),
+                             std::string("dedupGames ") + gamePoolName(pool) + " n=" + std::to_string(size));
+                deleteGames_(games);
+            }
+        }
+        std::cerr << "round " << round + 1 << " of " << rounds << ": " << tally.checks << " checks\n";
+    }
+
+    if (largeSize > 0) {
+        const std::vector<Game*> games = makeGamePool(GamePool::Varied, largeSize, generator);
+        for (const auto& comparator : SORT_COMPARATORS) {
+            for (const InputOrder order : {InputOrder::Random, InputOrder::Reversed, InputOrder::FewUnique}) {
+                const ArrangedInput arranged = arrangeInput(games, order, comparator, generator());
+                const std::vector<Game*>& input = arranged.games;
+                for (const auto& algorithm : SORT_ALGORITHMS) {
+                    if (!algorithm.quadratic) {
+                        tally.record(checkSort(algorithm, comparator, input),
+                                     std::string(algorithm.name) + ' ' + comparator.name + ' ' +
+                                     inputOrderName(order) + " varied n=" + std::to_string(largeSize));
+                    }
+                }
+                tally.record(checkPartialSort(comparator, input, largeSize),
+                             std::string("partial sort ") + comparator.name + ' ' + inputOrderName(order) +
+                             " varied n=" + std::to_string(largeSize));
+            }
+        }
+        for (const char* composite : COMPOSITE_ORDERS_) {
+            tally.record(checkCompositeSort(parseSortKeys(composite), games),
+                         std::string("compositeSort ") + composite + " varied n=" + std::to_string(largeSize));
+        }
+        tally.record(checkGameGroups(games, largeSize / 3 + 1),
+                     "dedupGames varied n=" + std::to_string(largeSize));
+        deleteGames_(games);
+    }
+
+    tally.record(checkRegressionGate_(generator), "benchmark regression gate");
+
+    std::cout << tally.checks << " checks, " << tally.failures << " failures\n";
+    return tally.failures == 0 ? 0 : 1;
+}